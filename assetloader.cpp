@@ -0,0 +1,220 @@
+#include "include/assetloader.h"
+
+using namespace XplatGameTutorial::PacManClone;
+
+AssetLoader::AssetLoader() :
+    _cRequests(0),
+    _iUpload(0),
+    _pThread(nullptr),
+    _fImageLoader(false)
+{
+    SDL_memset(_requests, 0, sizeof(_requests));
+    SDL_AtomicSet(&_cDecoded, 0);
+    SDL_AtomicSet(&_fDecodeFailed, 0);
+}
+
+AssetLoader::~AssetLoader()
+{
+    Cleanup();
+}
+
+void AssetLoader::Initialize(const char *pszPackPath)
+{
+    if (_pack.Open(pszPackPath))
+    {
+        printf("Loading textures from %s\n", pszPackPath);
+    }
+}
+
+TextureWrapper* AssetLoader::LoadNow(const char *pszImage, SDL_Color *pColorKey, SDL_Renderer *pSDLRenderer)
+{
+    TextureWrapper *pTexture = nullptr;
+    if (_pack.IsOpen())
+    {
+        pTexture = _pack.CreateTexture(pszImage, pSDLRenderer);
+    }
+
+    if (pTexture == nullptr)
+    {
+        // A failed IMG_Init shows up as the load failing
+        InitializeImageLoader();
+        pTexture = new TextureWrapper(pszImage, SDL_strlen(pszImage), pSDLRenderer, pColorKey);
+    }
+    return pTexture;
+}
+
+bool AssetLoader::Add(const char *pszImage, bool fColorKey, TextureWrapper *pTarget)
+{
+    SDL_assert(_pThread == nullptr);
+    if (_cRequests == c_maxRequests)
+    {
+        printf("AssetLoader::Add() : too many images, %s not queued\n", pszImage);
+        return false;
+    }
+
+    Request &request = _requests[_cRequests++];
+    SDL_memset(&request, 0, sizeof(request));
+    request.pszImage = pszImage;
+    request.fColorKey = fColorKey;
+    request.pTarget = pTarget;
+    return true;
+}
+
+// Anything in the pack is ready to go now, the worker only has the rest to do.  It goes through
+// the queue in order, so the uploads can follow it a request at a time
+bool AssetLoader::Start()
+{
+    bool fDecode = false;
+    for (size_t i = 0; i < _cRequests; i++)
+    {
+        Request &request = _requests[i];
+        const AssetPack::Texture *pTexture = _pack.IsOpen() ? _pack.FindTexture(request.pszImage) : nullptr;
+        if (pTexture != nullptr)
+        {
+            request.pPixels = _pack.Pixels(*pTexture);
+            request.format = pTexture->format;
+            request.width = pTexture->width;
+            request.height = pTexture->height;
+            request.pitch = pTexture->pitch;
+            request.blendMode = static_cast<SDL_BlendMode>(pTexture->blendMode);
+        }
+        else
+        {
+            fDecode = true;
+        }
+    }
+
+    if (!fDecode)
+    {
+        SDL_AtomicSet(&_cDecoded, static_cast<int>(_cRequests));
+        return true;
+    }
+
+    // IMG_Init isn't thread safe, do it before the worker needs it
+    if (!InitializeImageLoader())
+    {
+        return false;
+    }
+
+    _pThread = SDL_CreateThread(DecodeThread, "AssetDecode", this);
+    if (_pThread == nullptr)
+    {
+        printf("AssetLoader::Start() : SDL_CreateThread failed, error = %s\n", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+// Rows are uploaded a band at a time into a static texture, so the only copy the renderer makes
+// is the band itself.  A texture isn't handed over until all of it is there
+bool AssetLoader::UploadSlice(SDL_Renderer *pSDLRenderer)
+{
+    if (SDL_AtomicGet(&_fDecodeFailed) != 0)
+    {
+        return false;
+    }
+
+    int cbBudget = c_cbUploadSlice;
+    size_t cDecoded = static_cast<size_t>(SDL_AtomicGet(&_cDecoded));
+    while ((_iUpload < cDecoded) && (cbBudget > 0))
+    {
+        Request &request = _requests[_iUpload];
+        if (request.pTexture == nullptr)
+        {
+            request.pTexture = SDL_CreateTexture(pSDLRenderer, request.format, SDL_TEXTUREACCESS_STATIC, request.width, request.height);
+            if ((request.pTexture == nullptr) || (SDL_SetTextureBlendMode(request.pTexture, request.blendMode) != 0))
+            {
+                printf("Creating texture %s failed, error = %s\n", request.pszImage, SDL_GetError());
+                return false;
+            }
+        }
+
+        // Always at least a row, however wide
+        int cRows = SDL_min(SDL_max(cbBudget / request.pitch, 1), request.height - request.cRowsUploaded);
+        SDL_Rect rows = { 0, request.cRowsUploaded, request.width, cRows };
+        if (SDL_UpdateTexture(request.pTexture, &rows, request.pPixels + (request.cRowsUploaded * request.pitch), request.pitch) != 0)
+        {
+            printf("Uploading texture %s failed, error = %s\n", request.pszImage, SDL_GetError());
+            return false;
+        }
+        request.cRowsUploaded += cRows;
+        cbBudget -= cRows * request.pitch;
+
+        if (request.cRowsUploaded == request.height)
+        {
+            request.pTarget->SetTexture(request.pTexture, request.pszImage);
+            request.pTexture = nullptr;
+            SDL_FreeSurface(request.pSurface);
+            request.pSurface = nullptr;
+            request.pPixels = nullptr;
+            printf("loaded %s { w:%d, h:%d }\n", request.pszImage, request.width, request.height);
+            _iUpload++;
+        }
+    }
+
+    if (!IsLoading())
+    {
+        // Nothing points into the pack any more
+        _pack.Close();
+    }
+    return true;
+}
+
+void AssetLoader::Cleanup()
+{
+    if (_pThread != nullptr)
+    {
+        SDL_WaitThread(_pThread, nullptr);
+        _pThread = nullptr;
+    }
+
+    for (size_t i = 0; i < _cRequests; i++)
+    {
+        Request &request = _requests[i];
+        if (request.pTexture != nullptr)
+        {
+            SDL_DestroyTexture(request.pTexture);
+        }
+        SDL_FreeSurface(request.pSurface);
+    }
+    _cRequests = 0;
+    _iUpload = 0;
+    SDL_AtomicSet(&_cDecoded, 0);
+    _pack.Close();
+}
+
+// Only touches the requests the main thread isn't uploading yet, and publishes each one by
+// bumping _cDecoded once it's filled in
+int AssetLoader::DecodeThread(void *pData)
+{
+    AssetLoader *pLoader = static_cast<AssetLoader *>(pData);
+    for (size_t i = 0; i < pLoader->_cRequests; i++)
+    {
+        Request &request = pLoader->_requests[i];
+        if (request.pPixels == nullptr)
+        {
+            request.pSurface = AssetPack::DecodeImage(request.pszImage, request.fColorKey, &request.blendMode);
+            if (request.pSurface == nullptr)
+            {
+                SDL_AtomicSet(&pLoader->_fDecodeFailed, 1);
+                break;
+            }
+            request.pPixels = static_cast<const Uint8 *>(request.pSurface->pixels);
+            request.format = request.pSurface->format->format;
+            request.width = request.pSurface->w;
+            request.height = request.pSurface->h;
+            request.pitch = request.pSurface->pitch;
+        }
+        SDL_AtomicAdd(&pLoader->_cDecoded, 1);
+    }
+    return 0;
+}
+
+bool AssetLoader::InitializeImageLoader()
+{
+    if (!_fImageLoader)
+    {
+        _fImageLoader = InitializeSDLImage();
+    }
+    return _fImageLoader;
+}
@@ -0,0 +1,288 @@
+#include "include/assetpack.h"
+#include "include/constants.h"
+#include "SDL_image.h"
+
+using namespace XplatGameTutorial::PacManClone;
+
+namespace
+{
+    // FNV-1a, carried on from hash
+    Uint32 HashBytes(Uint32 hash, const void *pData, size_t cbData)
+    {
+        const Uint8 *pBytes = static_cast<const Uint8 *>(pData);
+        for (size_t i = 0; i < cbData; i++)
+        {
+            hash = (hash ^ pBytes[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    size_t AlignUp(size_t cb, size_t cbAlign)
+    {
+        return (cb + cbAlign - 1) & ~(cbAlign - 1);
+    }
+}
+
+AssetPack::AssetPack() :
+    _pData(nullptr),
+    _cbData(0)
+{
+}
+
+AssetPack::~AssetPack()
+{
+    Close();
+}
+
+bool AssetPack::Open(const char *pszPath)
+{
+    SDL_assert(!IsOpen());
+    if (!_file.Open(pszPath))
+    {
+        // Not an error as such, there's just no pack to use
+        return false;
+    }
+    _pData = _file.Data();
+    _cbData = _file.Size();
+
+    const Header *pHeader = reinterpret_cast<const Header *>(_pData);
+    bool fResult = (_cbData >= sizeof(Header)) && (SDL_memcmp(pHeader->magic, "PMCA", 4) == 0) &&
+        (pHeader->version == c_version) && (pHeader->cTextures <= (_cbData - sizeof(Header)) / sizeof(Texture));
+    if (fResult && (pHeader->layoutHash != LayoutHash()))
+    {
+        printf("AssetPack::Open() : %s was baked for different frames, rebake it with --bake-assets\n", pszPath);
+        Close();
+        return false;
+    }
+
+    const Texture *pTextures = reinterpret_cast<const Texture *>(pHeader + 1);
+    for (Uint32 i = 0; fResult && (i < pHeader->cTextures); i++)
+    {
+        const Texture &texture = pTextures[i];
+        fResult = (texture.name[sizeof(texture.name) - 1] == '\0') && (texture.width > 0) && (texture.height > 0) &&
+            (texture.pitch >= texture.width * 4) &&
+            (texture.cbPixels >= static_cast<Uint64>(texture.pitch) * static_cast<Uint64>(texture.height)) &&
+            (texture.offset <= _cbData) && (texture.cbPixels <= _cbData - texture.offset);
+    }
+
+    if (!fResult)
+    {
+        printf("AssetPack::Open() : %s is not a usable asset pack\n", pszPath);
+        Close();
+    }
+    return fResult;
+}
+
+void AssetPack::Close()
+{
+    _file.Close();
+    _pData = nullptr;
+    _cbData = 0;
+}
+
+TextureWrapper* AssetPack::CreateTexture(const char *pszName, SDL_Renderer *pSDLRenderer)
+{
+    const Texture *pTexture = FindTexture(pszName);
+    if (pTexture == nullptr)
+    {
+        printf("AssetPack::CreateTexture() : no %s in the pack\n", pszName);
+        return nullptr;
+    }
+
+    // The renderer copies the pixels out during the update, nothing keeps pointing into the map
+    SDL_Texture *pSDLTexture = SDL_CreateTexture(pSDLRenderer, pTexture->format, SDL_TEXTUREACCESS_STATIC, pTexture->width, pTexture->height);
+    if (pSDLTexture == nullptr)
+    {
+        printf("SDL_CreateTexture() failed, error = %s\n", SDL_GetError());
+        return nullptr;
+    }
+    if ((SDL_UpdateTexture(pSDLTexture, nullptr, Pixels(*pTexture), pTexture->pitch) != 0) ||
+        (SDL_SetTextureBlendMode(pSDLTexture, static_cast<SDL_BlendMode>(pTexture->blendMode)) != 0))
+    {
+        printf("Uploading %s failed, error = %s\n", pszName, SDL_GetError());
+        SDL_DestroyTexture(pSDLTexture);
+        return nullptr;
+    }
+    return new TextureWrapper(pSDLTexture, pTexture->name, SDL_strlen(pTexture->name));
+}
+
+const AssetPack::Texture* AssetPack::FindTexture(const char *pszName)
+{
+    if (_pData == nullptr)
+    {
+        return nullptr;
+    }
+
+    const Header *pHeader = reinterpret_cast<const Header *>(_pData);
+    const Texture *pTextures = reinterpret_cast<const Texture *>(pHeader + 1);
+    for (Uint32 i = 0; i < pHeader->cTextures; i++)
+    {
+        if (SDL_strcmp(pTextures[i].name, pszName) == 0)
+        {
+            return &pTextures[i];
+        }
+    }
+    return nullptr;
+}
+
+bool AssetPack::Bake(const char *pszPath)
+{
+    // Same images and color keys GameHarness loads the PNGs with
+    struct Source
+    {
+        const char *pszImage;
+        bool fColorKey;
+        Uint16 cxFrame;
+        Uint16 cyFrame;
+    };
+    static const Source c_sources[] =
+    {
+        { Constants::TilesImage, false, Constants::TileWidth, Constants::TileHeight },
+        { Constants::SpritesImage, true, Constants::GhostSpriteWidth, Constants::GhostSpriteHeight },
+        { Constants::TitleImage, false, Constants::ScreenWidth, Constants::ScreenHeight },
+    };
+    static const size_t c_cSources = SDL_arraysize(c_sources);
+
+    SDL_Surface *pSurfaces[c_cSources] = { };
+    Header header = { { 'P', 'M', 'C', 'A' }, c_version, LayoutHash(), static_cast<Uint32>(c_cSources) };
+    Texture textures[c_cSources];
+    SDL_memset(textures, 0, sizeof(textures));
+
+    bool fResult = true;
+    size_t offset = AlignUp(sizeof(Header) + sizeof(textures), c_cbAlign);
+    for (size_t i = 0; (i < c_cSources) && fResult; i++)
+    {
+        const Source &source = c_sources[i];
+        SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+        pSurfaces[i] = DecodeImage(source.pszImage, source.fColorKey, &blendMode);
+        if (pSurfaces[i] == nullptr)
+        {
+            fResult = false;
+            break;
+        }
+
+        SDL_Surface *pSurface = pSurfaces[i];
+        Texture &texture = textures[i];
+        SDL_strlcpy(texture.name, source.pszImage, sizeof(texture.name));
+        texture.format = c_pixelFormat;
+        texture.width = pSurface->w;
+        texture.height = pSurface->h;
+        texture.pitch = pSurface->w * 4;
+        texture.blendMode = blendMode;
+        texture.cxFrame = source.cxFrame;
+        texture.cyFrame = source.cyFrame;
+        texture.offset = offset;
+        texture.cbPixels = static_cast<Uint64>(texture.pitch) * texture.height;
+        offset = AlignUp(offset + static_cast<size_t>(texture.cbPixels), c_cbAlign);
+    }
+
+    SDL_RWops *pFile = fResult ? SDL_RWFromFile(pszPath, "wb") : nullptr;
+    if (fResult && (pFile == nullptr))
+    {
+        printf("AssetPack::Bake() : can't write %s, error = %s\n", pszPath, SDL_GetError());
+        fResult = false;
+    }
+
+    if (fResult)
+    {
+        static const Uint8 c_padding[c_cbAlign] = { };
+        size_t cbWritten = SDL_RWwrite(pFile, &header, 1, sizeof(header));
+        cbWritten += SDL_RWwrite(pFile, textures, 1, sizeof(textures));
+        for (size_t i = 0; i < c_cSources; i++)
+        {
+            cbWritten += SDL_RWwrite(pFile, c_padding, 1, static_cast<size_t>(textures[i].offset) - cbWritten);
+            SDL_Surface *pSurface = pSurfaces[i];
+            for (int y = 0; y < pSurface->h; y++)
+            {
+                cbWritten += SDL_RWwrite(pFile, static_cast<Uint8 *>(pSurface->pixels) + (y * pSurface->pitch), 1, textures[i].pitch);
+            }
+        }
+        fResult = (cbWritten == textures[c_cSources - 1].offset + textures[c_cSources - 1].cbPixels);
+        if (SDL_RWclose(pFile) != 0)
+        {
+            fResult = false;
+        }
+        printf("Baked %u textures into %s (%u bytes)\n", static_cast<unsigned int>(c_cSources), pszPath, static_cast<unsigned int>(cbWritten));
+    }
+
+    for (size_t i = 0; i < c_cSources; i++)
+    {
+        SDL_FreeSurface(pSurfaces[i]);
+    }
+    return fResult;
+}
+
+// Decoded, converted to c_pixelFormat and keyed, ready to be written out or uploaded.  Touches
+// nothing shared, so the AssetLoader calls this from its worker thread
+SDL_Surface* AssetPack::DecodeImage(const char *pszImage, bool fColorKey, SDL_BlendMode *pBlendMode)
+{
+    SDL_Surface *pLoaded = IMG_Load(pszImage);
+    if (pLoaded == nullptr)
+    {
+        printf("IMG_Load() failed, error = %s\n", IMG_GetError());
+        return nullptr;
+    }
+
+    // Blended if it had alpha or a color key, same as SDL_CreateTextureFromSurface would pick
+    *pBlendMode = ((pLoaded->format->Amask != 0) || fColorKey) ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE;
+    SDL_Surface *pSurface = SDL_ConvertSurfaceFormat(pLoaded, c_pixelFormat, 0);
+    SDL_FreeSurface(pLoaded);
+    if ((pSurface == nullptr) || (SDL_LockSurface(pSurface) != 0))
+    {
+        printf("Converting %s failed, error = %s\n", pszImage, SDL_GetError());
+        SDL_FreeSurface(pSurface);
+        return nullptr;
+    }
+
+    if (fColorKey)
+    {
+        // Key out every opaque magenta pixel, what SDL would have done at draw time
+        SDL_Color key = Constants::SDLColorMagenta;
+        Uint32 keyPixel = SDL_MapRGB(pSurface->format, key.r, key.g, key.b);
+        for (int y = 0; y < pSurface->h; y++)
+        {
+            Uint32 *pRow = reinterpret_cast<Uint32 *>(static_cast<Uint8 *>(pSurface->pixels) + (y * pSurface->pitch));
+            for (int x = 0; x < pSurface->w; x++)
+            {
+                if (pRow[x] == keyPixel)
+                {
+                    pRow[x] = 0;
+                }
+            }
+        }
+    }
+    SDL_UnlockSurface(pSurface);
+    return pSurface;
+}
+
+Uint32 AssetPack::LayoutHash()
+{
+    const Uint16 sizes[] =
+    {
+        Constants::TileTextureWidth, Constants::TileTextureHeight,
+        Constants::SpriteTextureWidth, Constants::SpriteTextureHeight,
+        Constants::TileWidth, Constants::TileHeight,
+        Constants::PlayerSpriteWidth, Constants::PlayerSpriteHeight,
+        Constants::GhostSpriteWidth, Constants::GhostSpriteHeight,
+        Constants::PlayerTotalFrameCount, Constants::GhostTotalFrameCount
+    };
+
+    Uint32 hash = 2166136261u;
+    hash = HashBytes(hash, sizes, sizeof(sizes));
+    hash = HashBytes(hash, Constants::PlayerAnimation_UP, sizeof(Constants::PlayerAnimation_UP));
+    hash = HashBytes(hash, Constants::PlayerAnimation_DOWN, sizeof(Constants::PlayerAnimation_DOWN));
+    hash = HashBytes(hash, Constants::PlayerAnimation_LEFT, sizeof(Constants::PlayerAnimation_LEFT));
+    hash = HashBytes(hash, Constants::PlayerAnimation_RIGHT, sizeof(Constants::PlayerAnimation_RIGHT));
+    hash = HashBytes(hash, Constants::PlayerAnimation_DEATH, sizeof(Constants::PlayerAnimation_DEATH));
+    hash = HashBytes(hash, Constants::GhostAnimation_UP, sizeof(Constants::GhostAnimation_UP));
+    hash = HashBytes(hash, Constants::GhostAnimation_DOWN, sizeof(Constants::GhostAnimation_DOWN));
+    hash = HashBytes(hash, Constants::GhostAnimation_LEFT, sizeof(Constants::GhostAnimation_LEFT));
+    hash = HashBytes(hash, Constants::GhostAnimation_RIGHT, sizeof(Constants::GhostAnimation_RIGHT));
+    hash = HashBytes(hash, Constants::GhostAnimation_FRIGHT, sizeof(Constants::GhostAnimation_FRIGHT));
+    hash = HashBytes(hash, Constants::GhostAnimation_SCARED, sizeof(Constants::GhostAnimation_SCARED));
+    hash = HashBytes(hash, Constants::GhostAnimation_DEATHUP, sizeof(Constants::GhostAnimation_DEATHUP));
+    hash = HashBytes(hash, Constants::GhostAnimation_DEATHDOWN, sizeof(Constants::GhostAnimation_DEATHDOWN));
+    hash = HashBytes(hash, Constants::GhostAnimation_DEATHLEFT, sizeof(Constants::GhostAnimation_DEATHLEFT));
+    hash = HashBytes(hash, Constants::GhostAnimation_DEATHRIGHT, sizeof(Constants::GhostAnimation_DEATHRIGHT));
+    return hash;
+}
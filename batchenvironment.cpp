@@ -0,0 +1,157 @@
+#include "include/batchenvironment.h"
+
+using namespace XplatGameTutorial::PacManClone;
+
+BatchEnvironment::BatchEnvironment() :
+    _cGames(0),
+    _cMaxEpisodeTicks(0),
+    _pTilesTexture(nullptr),
+    _pSpriteTexture(nullptr),
+    _pGames(nullptr),
+    _pClocks(nullptr),
+    _pEpisodeTicks(nullptr),
+    _pTileLayers(nullptr),
+    _pStartTileLayer(nullptr),
+    _pStartSnapshot(nullptr)
+{
+}
+
+BatchEnvironment::~BatchEnvironment()
+{
+    // The games go first, their sprites point at the textures
+    delete[] _pGames;
+    delete[] _pClocks;
+    delete[] _pEpisodeTicks;
+    delete[] _pTileLayers;
+    delete[] _pStartTileLayer;
+    delete _pStartSnapshot;
+    delete _pSpriteTexture;
+    delete _pTilesTexture;
+}
+
+// Everything is allocated up front, each game gets its own maze and sprites
+bool BatchEnvironment::Initialize(size_t cGames, Uint32 cMaxEpisodeTicks, bool fTruePathing)
+{
+    SDL_assert(_pGames == nullptr);
+    if (cGames == 0)
+    {
+        printf("BatchEnvironment::Initialize() : need at least one game\n");
+        return false;
+    }
+
+    _cGames = cGames;
+    _cMaxEpisodeTicks = cMaxEpisodeTicks;
+    _pTilesTexture = new TextureWrapper(Constants::TileTextureWidth, Constants::TileTextureHeight);
+    _pSpriteTexture = new TextureWrapper(Constants::SpriteTextureWidth, Constants::SpriteTextureHeight);
+    _pGames = new Simulation[_cGames];
+    _pClocks = new GameClock[_cGames];
+    _pEpisodeTicks = new Uint32[_cGames] { };
+    _pTileLayers = new Uint8[_cGames * ObservationSize];
+    _pStartTileLayer = new Uint8[ObservationSize];
+    _pStartSnapshot = new GameSnapshot();
+
+    for (size_t i = 0; i < _cGames; i++)
+    {
+        _pGames[i].Initialize(_pTilesTexture, _pSpriteTexture, &_pClocks[i]);
+        _pGames[i].SetTruePathing(fTruePathing);
+        _pGames[i].InitLevel();
+    }
+
+    // Every game starts from exactly the same place, so one snapshot of it resets any of them
+    _pGames[0].Save(_pStartSnapshot);
+
+    Maze *pMaze = _pGames[0].GetMaze();
+    for (Uint16 row = 0; row < Constants::MapRows; row++)
+    {
+        for (Uint16 col = 0; col < Constants::MapCols; col++)
+        {
+            Uint8 tile = 0;
+            if (pMaze->IsTileSolid(row, col))
+            {
+                tile |= ObservationWall;
+            }
+            if (pMaze->IsTilePellet(row, col))
+            {
+                tile |= ObservationPellet;
+            }
+            if (pMaze->IsTilePowerPellet(row, col))
+            {
+                tile |= ObservationPowerPellet;
+            }
+            _pStartTileLayer[(row * Constants::MapCols) + col] = tile;
+        }
+    }
+
+    for (size_t i = 0; i < _cGames; i++)
+    {
+        SDL_memcpy(TileLayer(i), _pStartTileLayer, ObservationSize);
+    }
+    return true;
+}
+
+void BatchEnvironment::Reset(Uint8 *pObservations)
+{
+    for (size_t i = 0; i < _cGames; i++)
+    {
+        ResetGame(i);
+        WriteObservation(i, pObservations + (i * ObservationSize));
+    }
+}
+
+void BatchEnvironment::Step(const Uint8 *pActions, Uint8 *pObservations, float *pRewards, Uint8 *pDones)
+{
+    for (size_t i = 0; i < _cGames; i++)
+    {
+        Direction inputDirection = (pActions[i] < static_cast<Uint8>(Direction::None)) ? static_cast<Direction>(pActions[i]) : Direction::None;
+
+        _pClocks[i].Tick();
+        Simulation::StepResult result = _pGames[i].Step(inputDirection);
+        _pEpisodeTicks[i]++;
+
+        Uint16 points = 0;
+        if (result.cPelletsEaten != 0)
+        {
+            // The player is on the tile they just ate
+            const Blackboard &blackboard = _pGames[i].GetBlackboard();
+            TileLayer(i)[(blackboard.playerRow * Constants::MapCols) + blackboard.playerCol] &= ~(ObservationPellet | ObservationPowerPellet);
+            points = result.fPowerPellet ? Constants::PowerPelletPoints : Constants::PelletPoints;
+        }
+
+        bool fDone = result.fPlayerCaught || result.fLevelComplete ||
+            ((_cMaxEpisodeTicks != 0) && (_pEpisodeTicks[i] >= _cMaxEpisodeTicks));
+        if (fDone)
+        {
+            ResetGame(i);
+        }
+
+        pRewards[i] = static_cast<float>(points);
+        pDones[i] = fDone ? 1 : 0;
+        WriteObservation(i, pObservations + (i * ObservationSize));
+    }
+}
+
+void BatchEnvironment::ResetGame(size_t iGame)
+{
+    _pGames[iGame].Restore(*_pStartSnapshot);
+    SDL_memcpy(TileLayer(iGame), _pStartTileLayer, ObservationSize);
+    _pEpisodeTicks[iGame] = 0;
+}
+
+// The walls and pellets are kept in observation form as we go, so this is a copy plus the sprites
+void BatchEnvironment::WriteObservation(size_t iGame, Uint8 *pObservation)
+{
+    SDL_memcpy(pObservation, TileLayer(iGame), ObservationSize);
+
+    // Tiles the ghosts and player can't be resolved to (off the map in the warp tunnel) keep their
+    // last known value in the blackboard, which is close enough
+    const Blackboard &blackboard = _pGames[iGame].GetBlackboard();
+    pObservation[(blackboard.playerRow * Constants::MapCols) + blackboard.playerCol] |= ObservationPlayer;
+    for (size_t i = 0; i < Blackboard::c_maxGhosts; i++)
+    {
+        if (_pGames[iGame].GetGhost(i) != nullptr)
+        {
+            const Blackboard::GhostInfo &info = blackboard.ghosts[i];
+            pObservation[(info.row * Constants::MapCols) + info.col] |= info.fScatter ? ObservationScaredGhost : ObservationGhost;
+        }
+    }
+}
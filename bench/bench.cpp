@@ -0,0 +1,681 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include "SDL_image.h"
+#include "gameharness.h"
+#include "batchenvironment.h"
+#include "ghoststore.h"
+#include "mazepack.h"
+
+// Microbenchmarks for the simulation and render hot paths, built and run by "make bench".
+//
+// Every benchmark works from scripted positions so runs are repeatable.  Each one is timed as
+// c_cReps repetitions of a fixed number of iterations (after a few warm up repetitions) and we
+// report the median time per iteration along with the minimum and the median absolute deviation,
+// which hold up far better than a mean against the odd preempted repetition.
+//
+//   pmc_bench [--out results.csv] [--baseline baseline.csv] [--threshold percent]
+//
+// Results are always printed as CSV.  Given a baseline (a previous --out file) each benchmark is
+// compared against it and the exit code is 1 if anything got slower than the threshold (default
+// 10%) by more than its own noise.
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Friend of the GameHarness so it can step the running state directly
+    class Benchmark
+    {
+    public:
+        struct Result
+        {
+            char name[48];
+            Uint32 cIterations;
+            double nsMedian;
+            double nsMin;
+            double nsMad;
+        };
+
+        Benchmark() :
+            _counterFrequency(SDL_GetPerformanceFrequency()),
+            _cResults(0),
+            _sink(0)
+        {
+        }
+
+        int Run(int argc, char **argv);
+
+    private:
+        static const Uint32 c_cWarmupReps = 3;
+        static const Uint32 c_cReps = 25;
+        static const Uint32 c_maxResults = 24;
+
+        // reset runs (untimed) before each repetition, body(i) is the thing being measured
+        template <typename Reset, typename Body>
+        void Measure(const char *pszName, Uint32 cIterations, Reset reset, Body body);
+
+        void BenchMaze();
+        void BenchGhost();
+        void BenchGhostStore();
+        void BenchPathHierarchy();
+        void BenchSprites();
+        void BenchTiledMapRender();
+        void BenchOnRunning();
+        void BenchBatchEnvironment();
+
+        void WriteResults(FILE *pFile);
+        int CompareWithBaseline(const char *pszPath, double threshold);
+
+        Uint64 _counterFrequency;
+        Result _results[c_maxResults];
+        Uint32 _cResults;
+        volatile Uint64 _sink;      // Somewhere for results to go so the work isn't optimized away
+    };
+}
+}
+
+using namespace XplatGameTutorial::PacManClone;
+
+namespace
+{
+    // Same generator everywhere so the scripted positions never change between runs
+    Uint32 s_seed = 12345;
+    Uint32 NextRandom()
+    {
+        s_seed = (s_seed * 1103515245) + 12345;
+        return (s_seed >> 16) & 0x7FFF;
+    }
+
+    // Gives us access to the ghost's targeting
+    class TargetingGhost : public Blinky
+    {
+    public:
+        TargetingGhost(TextureWrapper *pTextureWrapper) : Blinky(pTextureWrapper) { }
+        using Ghost::ShortestDirectionToTarget;
+    };
+
+    Maze *CreateMaze(SDL_Texture *pTexture)
+    {
+        Maze *pMaze = new Maze(Constants::ClassicMaze, Constants::ScreenWidth, Constants::ScreenHeight);
+        pMaze->Initialize({ 0, 0, Constants::TileTextureWidth, Constants::TileTextureHeight },
+            { 0, 0, Constants::TileWidth, Constants::TileHeight }, pTexture);
+        return pMaze;
+    }
+}
+
+template <typename Reset, typename Body>
+void Benchmark::Measure(const char *pszName, Uint32 cIterations, Reset reset, Body body)
+{
+    SDL_assert(_cResults < c_maxResults);
+    double nsPerIteration[c_cReps];
+
+    for (Uint32 rep = 0; rep < c_cWarmupReps + c_cReps; rep++)
+    {
+        reset();
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (Uint32 i = 0; i < cIterations; i++)
+        {
+            body(i);
+        }
+        Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+        if (rep >= c_cWarmupReps)
+        {
+            nsPerIteration[rep - c_cWarmupReps] = (static_cast<double>(elapsed) * 1e9) / (static_cast<double>(_counterFrequency) * cIterations);
+        }
+    }
+
+    std::sort(nsPerIteration, nsPerIteration + c_cReps);
+    double deviations[c_cReps];
+    for (Uint32 rep = 0; rep < c_cReps; rep++)
+    {
+        deviations[rep] = SDL_fabs(nsPerIteration[rep] - nsPerIteration[c_cReps / 2]);
+    }
+    std::sort(deviations, deviations + c_cReps);
+
+    Result &result = _results[_cResults++];
+    SDL_strlcpy(result.name, pszName, sizeof(result.name));
+    result.cIterations = cIterations;
+    result.nsMedian = nsPerIteration[c_cReps / 2];
+    result.nsMin = nsPerIteration[0];
+    result.nsMad = deviations[c_cReps / 2];
+    fprintf(stderr, "%-28s %12.2f ns\n", pszName, result.nsMedian);
+}
+
+// Tile queries and Distance over every tile, and a fixed set of tile pairs
+void Benchmark::BenchMaze()
+{
+    Maze *pMaze = CreateMaze(nullptr);
+    const Uint32 cTiles = Constants::MapRows * Constants::MapCols;
+
+    Measure("Maze::IsTileIntersection", cTiles * 64, [] { },
+        [&](Uint32 i)
+        {
+            Uint32 tile = i % cTiles;
+            _sink += pMaze->IsTileIntersection(static_cast<Uint16>(tile / Constants::MapCols), static_cast<Uint16>(tile % Constants::MapCols));
+        });
+
+    Measure("Maze::PelletsRemaining", 65536, [] { },
+        [&](Uint32 /*i*/)
+        {
+            _sink += pMaze->PelletsRemaining();
+        });
+
+    Uint16 pairs[256][4];
+    for (size_t i = 0; i < SDL_arraysize(pairs); i++)
+    {
+        pairs[i][0] = NextRandom() % Constants::MapRows;
+        pairs[i][1] = NextRandom() % Constants::MapCols;
+        pairs[i][2] = NextRandom() % Constants::MapRows;
+        pairs[i][3] = NextRandom() % Constants::MapCols;
+    }
+    Measure("Distance", 65536, [] { },
+        [&](Uint32 i)
+        {
+            const Uint16 *pPair = pairs[i % SDL_arraysize(pairs)];
+            _sink += static_cast<Uint64>(Distance(pPair[0], pPair[1], pPair[2], pPair[3]));
+        });
+
+    delete pMaze;
+
+    // Picking a maze out of a mapped pack, all the loading a level has to do
+    static const char c_szMazePack[] = "bench_mazes.pmcm";
+    MazePack mazePack;
+    if (MazePack::Write(c_szMazePack, &Constants::ClassicMaze, 1) && mazePack.Open(c_szMazePack))
+    {
+        Measure("MazePack::GetLayout", 65536, [] { },
+            [&](Uint32 /*i*/)
+            {
+                MazeLayout layout;
+                _sink += mazePack.GetLayout(0, &layout) ? layout.cPellets : 0;
+            });
+        mazePack.Close();
+    }
+    remove(c_szMazePack);
+}
+
+// A ghost deciding at every intersection of the maze against a scripted list of targets
+void Benchmark::BenchGhost()
+{
+    TextureWrapper texture(Constants::SpriteTextureWidth, Constants::SpriteTextureHeight);
+    Maze *pMaze = CreateMaze(nullptr);
+    TargetingGhost *pGhost = new TargetingGhost(&texture);
+    pGhost->Initialize();
+    pGhost->Reset(pMaze);
+
+    Uint16 intersections[Constants::MapRows * Constants::MapCols][2];
+    Uint32 cIntersections = 0;
+    for (Uint16 row = 0; row < Constants::MapRows; row++)
+    {
+        for (Uint16 col = 0; col < Constants::MapCols; col++)
+        {
+            if (pMaze->IsTileIntersection(row, col))
+            {
+                intersections[cIntersections][0] = row;
+                intersections[cIntersections][1] = col;
+                cIntersections++;
+            }
+        }
+    }
+
+    Uint16 targets[64][2];
+    for (size_t i = 0; i < SDL_arraysize(targets); i++)
+    {
+        targets[i][0] = NextRandom() % Constants::MapRows;
+        targets[i][1] = NextRandom() % Constants::MapCols;
+    }
+
+    Measure("Ghost::ShortestDirection", cIntersections * 64, [] { },
+        [&](Uint32 i)
+        {
+            const Uint16 *pOrigin = intersections[i % cIntersections];
+            const Uint16 *pTarget = targets[(i / cIntersections) % SDL_arraysize(targets)];
+            _sink += static_cast<Uint64>(pGhost->ShortestDirectionToTarget(pOrigin[0], pOrigin[1], pTarget[0], pTarget[1], pMaze));
+        });
+
+    delete pGhost;
+    delete pMaze;
+}
+
+// A crowd of ghosts, everyone out of the pen, chasing a player that moves about the maze.  One
+// iteration updates every ghost once, so this is the cost per ghost
+void Benchmark::BenchGhostStore()
+{
+    static const size_t c_cGhosts = 1024;
+    GameClock clock;
+    Maze *pMaze = CreateMaze(nullptr);
+    GhostStore *pStore = new GhostStore();
+    pStore->Initialize(c_cGhosts, &clock);
+    pStore->Reset(pMaze, c_cGhosts);
+
+    Uint16 targets[64][2];
+    for (size_t i = 0; i < SDL_arraysize(targets); i++)
+    {
+        targets[i][0] = NextRandom() % Constants::MapRows;
+        targets[i][1] = NextRandom() % Constants::MapCols;
+    }
+
+    // Run until the last ghost has left the pen
+    Blackboard blackboard;
+    blackboard.playerRow = targets[0][0];
+    blackboard.playerCol = targets[0][1];
+    for (Uint32 tick = 0; tick < ((c_cGhosts + 1) * Constants::FramesPerSecond) / 4; tick++)
+    {
+        clock.Tick();
+        pStore->Update(blackboard, pMaze);
+    }
+
+    Measure("GhostStore::Update per ghost", c_cGhosts * 64, [] { },
+        [&](Uint32 i)
+        {
+            if ((i % c_cGhosts) == 0)
+            {
+                const Uint16 *pTarget = targets[(i / c_cGhosts) % SDL_arraysize(targets)];
+                blackboard.playerRow = pTarget[0];
+                blackboard.playerCol = pTarget[1];
+                blackboard.fourAheadRow = pTarget[0];
+                blackboard.fourAheadCol = pTarget[1];
+                clock.Tick();
+                pStore->Update(blackboard, pMaze);
+                _sink += pStore->Col(0);
+            }
+        });
+
+    delete pStore;
+    delete pMaze;
+}
+
+// Repathing on a 1024x1024 maze: a lattice of corridors every other tile with a scripted quarter of
+// the joins walled off.  Four targets shared by every query, like the ghosts of a crowd, so this is
+// the cost once the searches behind them are mostly done
+void Benchmark::BenchPathHierarchy()
+{
+    static const Uint16 c_side = 1024;
+    static const Uint32 c_cTiles = static_cast<Uint32>(c_side) * c_side;
+    Uint8 *pOpen = new Uint8[c_cTiles];
+    for (Uint32 tile = 0; tile < c_cTiles; tile++)
+    {
+        Uint16 row = static_cast<Uint16>(tile / c_side);
+        Uint16 col = static_cast<Uint16>(tile % c_side);
+        bool fRoom = ((row & 1) == 1) && ((col & 1) == 1);
+        bool fJoin = (((row & 1) == 1) != ((col & 1) == 1)) && (row > 0) && (col > 0) && (row < c_side - 1) && (col < c_side - 1);
+        pOpen[tile] = fRoom || (fJoin && ((NextRandom() % 4) != 0));
+    }
+
+    Uint8 *pExitMasks = new Uint8[c_cTiles];
+    for (Uint32 tile = 0; tile < c_cTiles; tile++)
+    {
+        Uint16 row = static_cast<Uint16>(tile / c_side);
+        Uint16 col = static_cast<Uint16>(tile % c_side);
+        Uint8 exits = 0;
+        if (pOpen[tile])
+        {
+            exits |= ((row > 0) && pOpen[tile - c_side]) ? (1 << static_cast<int>(Direction::Up)) : 0;
+            exits |= ((row < c_side - 1) && pOpen[tile + c_side]) ? (1 << static_cast<int>(Direction::Down)) : 0;
+            exits |= ((col > 0) && pOpen[tile - 1]) ? (1 << static_cast<int>(Direction::Left)) : 0;
+            exits |= ((col < c_side - 1) && pOpen[tile + 1]) ? (1 << static_cast<int>(Direction::Right)) : 0;
+        }
+        pExitMasks[tile] = exits;
+    }
+
+    PathHierarchy *pHierarchy = new PathHierarchy();
+    Uint16 start = c_side / 2 + 1;
+    if (pHierarchy->Build(c_side, c_side, pExitMasks, start, start))
+    {
+        Uint16 origins[1024][3];
+        for (size_t i = 0; i < SDL_arraysize(origins); i++)
+        {
+            origins[i][0] = (NextRandom() % (c_side / 2)) * 2 + 1;
+            origins[i][1] = (NextRandom() % (c_side / 2)) * 2 + 1;
+            origins[i][2] = NextRandom() % 5;
+        }
+        Uint16 targets[4][2];
+        for (size_t i = 0; i < SDL_arraysize(targets); i++)
+        {
+            targets[i][0] = NextRandom() % c_side;
+            targets[i][1] = NextRandom() % c_side;
+        }
+
+        Measure("PathHierarchy::NextDirection", 4096, [] { },
+            [&](Uint32 i)
+            {
+                const Uint16 *pOrigin = origins[i % SDL_arraysize(origins)];
+                const Uint16 *pTarget = targets[i % SDL_arraysize(targets)];
+                _sink += static_cast<Uint64>(pHierarchy->NextDirection(pOrigin[0], pOrigin[1], static_cast<Direction>(pOrigin[2]), pTarget[0], pTarget[1]));
+            });
+    }
+
+    delete pHierarchy;
+    delete[] pExitMasks;
+    delete[] pOpen;
+}
+
+void Benchmark::BenchSprites()
+{
+    TextureWrapper texture(Constants::SpriteTextureWidth, Constants::SpriteTextureHeight);
+    Player *pPlayer = new Player(&texture);
+    pPlayer->Initialize();
+    pPlayer->SetAnimation(Constants::AnimationIndexLeft);
+
+    // Just the base movement and animation, not the player's maze logic
+    Sprite *pSprite = pPlayer;
+    Measure("Sprite::Update", 65536,
+        [&]
+        {
+            pSprite->ResetPosition(400, 300);
+            pSprite->SetVelocity(-Constants::PlayerMaxSpeed, 0);
+        },
+        [&](Uint32 /*i*/)
+        {
+            pSprite->Update();
+        });
+    _sink += static_cast<Uint64>(pSprite->X());
+
+    SpriteAnimation animation(Constants::PlayerAnimationFrameCount, Constants::PlayerAnimation_UP, AnimationType::Loop, Constants::PlayerAnimationSpeed);
+    Measure("SpriteAnimation::Update", 65536, [&] { animation.Reset(); },
+        [&](Uint32 /*i*/)
+        {
+            animation.Update();
+        });
+    _sink += static_cast<Uint64>(animation.CurrentFrame());
+
+    delete pPlayer;
+}
+
+// The maze drawn with SDL's software renderer: presenting the cached map, redrawing the cache
+// from scratch (what a full invalidation costs), and scrolling around maps far bigger than the window
+void Benchmark::BenchTiledMapRender()
+{
+    SDL_Surface *pSurface = SDL_CreateRGBSurface(0, Constants::ScreenWidth, Constants::ScreenHeight, 32, 0, 0, 0, 0);
+    SDL_Renderer *pRenderer = (pSurface != nullptr) ? SDL_CreateSoftwareRenderer(pSurface) : nullptr;
+    if (pRenderer == nullptr)
+    {
+        printf("Skipping render benchmarks, no software renderer! SDL Error: %s\n", SDL_GetError());
+        SDL_FreeSurface(pSurface);
+        return;
+    }
+
+    SDL_Color colorKey = Constants::SDLColorMagenta;
+    TextureWrapper *pTiles = new TextureWrapper(Constants::TilesImage, SDL_strlen(Constants::TilesImage), pRenderer, &colorKey);
+    if (pTiles->Ptr() == nullptr)
+    {
+        printf("Skipping render benchmarks, run from the repository root so %s can be found\n", Constants::TilesImage);
+    }
+    else
+    {
+        Maze *pMaze = CreateMaze(pTiles->Ptr());
+        pMaze->BakeCache(pRenderer);
+
+        Measure("TiledMap::Render", 256, [] { },
+            [&](Uint32 /*i*/)
+            {
+                pMaze->Render(pRenderer);
+            });
+
+        Measure("TiledMap::Render (rebake)", 64, [] { },
+            [&](Uint32 /*i*/)
+            {
+                pMaze->InvalidateCache();
+                pMaze->Render(pRenderer);
+            });
+        delete pMaze;
+
+        // The classic maze tiled out as far as a maze can go, with the view panning across it.
+        // Should cost about the same as the classic maze
+        const Uint16 c_cBigSide = 128;
+        Uint16 *pIndices = new Uint16[c_cBigSide * c_cBigSide];
+        for (Uint16 row = 0; row < c_cBigSide; row++)
+        {
+            for (Uint16 col = 0; col < c_cBigSide; col++)
+            {
+                pIndices[(row * c_cBigSide) + col] = Constants::MapIndicies[((row % Constants::MapRows) * Constants::MapCols) + (col % Constants::MapCols)];
+            }
+        }
+        TiledMap *pBigMap = new TiledMap(c_cBigSide, c_cBigSide, Constants::ScreenWidth, Constants::ScreenHeight);
+        pBigMap->Initialize({ 0, 0, Constants::TileTextureWidth, Constants::TileTextureHeight },
+            { 0, 0, Constants::TileWidth, Constants::TileHeight }, pTiles->Ptr(), pIndices, c_cBigSide * c_cBigSide);
+        pBigMap->BakeCache(pRenderer);
+
+        SDL_Rect bounds = pBigMap->GetMapBounds();
+        Measure("TiledMap::Render (128x128)", 256, [] { },
+            [&](Uint32 i)
+            {
+                pBigMap->CenterViewOn((i * 7) % bounds.w, (i * 5) % bounds.h);
+                pBigMap->Render(pRenderer);
+            });
+        delete pBigMap;
+        delete[] pIndices;
+
+        // Four million tiles with room for a few screens of them, jumping somewhere new every frame
+        // so nearly every frame streams chunks in and evicts others
+        const Uint16 c_cHugeSide = 2048;
+        const size_t c_cHugeTiles = static_cast<size_t>(c_cHugeSide) * c_cHugeSide;
+        pIndices = new Uint16[c_cHugeTiles];
+        for (size_t tile = 0; tile < c_cHugeTiles; tile++)
+        {
+            pIndices[tile] = Constants::MapIndicies[tile % SDL_arraysize(Constants::MapIndicies)];
+        }
+        pBigMap = new TiledMap(c_cHugeSide, c_cHugeSide, Constants::ScreenWidth, Constants::ScreenHeight);
+        pBigMap->Initialize({ 0, 0, Constants::TileTextureWidth, Constants::TileTextureHeight },
+            { 0, 0, Constants::TileWidth, Constants::TileHeight }, pTiles->Ptr(), pIndices, c_cHugeTiles, 256 * 1024);
+
+        bounds = pBigMap->GetMapBounds();
+        Measure("TiledMap::Render (2048x2048)", 256, [] { },
+            [&](Uint32 /*i*/)
+            {
+                pBigMap->CenterViewOn(static_cast<int>((NextRandom() * 7) % bounds.w), static_cast<int>((NextRandom() * 5) % bounds.h));
+                pBigMap->Render(pRenderer);
+            });
+        delete pBigMap;
+        delete[] pIndices;
+    }
+
+    delete pTiles;
+    SDL_DestroyRenderer(pRenderer);
+    SDL_FreeSurface(pSurface);
+}
+
+// Whole simulation ticks of a headless game, starting from the same point every repetition
+void Benchmark::BenchOnRunning()
+{
+    GameHarness *pHarness = new GameHarness();
+    if (!pHarness->Initialize(true))
+    {
+        printf("Skipping OnRunning benchmark, headless initialize failed\n");
+        delete pHarness;
+        return;
+    }
+
+    // Step through the title and level start to the point the level is running
+    while (pHarness->_state != GameHarness::GameState::Running)
+    {
+        pHarness->UpdateState();
+    }
+
+    Measure("GameHarness::OnRunning", 600,
+        [&]
+        {
+            pHarness->InitLevel();
+            pHarness->_state = GameHarness::GameState::Running;
+        },
+        [&](Uint32 /*i*/)
+        {
+            pHarness->_clock.Tick();
+            _sink += static_cast<Uint64>(pHarness->OnRunning());
+        });
+
+    // Mid level, so the snapshot has moved ghosts and eaten pellets in it
+    GameSnapshot *pSnapshot = new GameSnapshot();
+    Measure("GameHarness::SaveSnapshot", 4096, [] { },
+        [&](Uint32 /*i*/)
+        {
+            pHarness->SaveSnapshot(pSnapshot);
+            _sink += pSnapshot->clockTicks;
+        });
+
+    Measure("GameHarness::RestoreSnapshot", 4096, [] { },
+        [&](Uint32 /*i*/)
+        {
+            pHarness->RestoreSnapshot(*pSnapshot);
+            _sink += pHarness->_clock.Ticks();
+        });
+    delete pSnapshot;
+
+    pHarness->Cleanup();
+    delete pHarness;
+}
+
+// One iteration steps every game once, so this is the cost of a single game step
+void Benchmark::BenchBatchEnvironment()
+{
+    static const size_t c_cGames = 256;
+    BatchEnvironment environment;
+    if (!environment.Initialize(c_cGames, 2000))
+    {
+        return;
+    }
+
+    Uint8 *pActions = new Uint8[c_cGames] { };
+    Uint8 *pObservations = new Uint8[c_cGames * BatchEnvironment::ObservationSize];
+    float *pRewards = new float[c_cGames];
+    Uint8 *pDones = new Uint8[c_cGames];
+    environment.Reset(pObservations);
+
+    Uint32 seed = 1;
+    Measure("BatchEnvironment::Step per game", c_cGames * 64, [] { },
+        [&](Uint32 i)
+        {
+            if ((i % c_cGames) == 0)
+            {
+                // A new direction for everyone every so often, like a player would
+                for (size_t j = 0; j < c_cGames; j++)
+                {
+                    seed = (seed * 1103515245) + 12345;
+                    pActions[j] = ((seed >> 16) % 32 == 0) ? static_cast<Uint8>((seed >> 8) % 5) : pActions[j];
+                }
+                environment.Step(pActions, pObservations, pRewards, pDones);
+                _sink += pDones[0];
+            }
+        });
+
+    delete[] pDones;
+    delete[] pRewards;
+    delete[] pObservations;
+    delete[] pActions;
+}
+
+void Benchmark::WriteResults(FILE *pFile)
+{
+    fprintf(pFile, "benchmark,iterations,median_ns,min_ns,mad_ns\n");
+    for (Uint32 i = 0; i < _cResults; i++)
+    {
+        fprintf(pFile, "%s,%u,%.3f,%.3f,%.3f\n", _results[i].name, _results[i].cIterations,
+            _results[i].nsMedian, _results[i].nsMin, _results[i].nsMad);
+    }
+}
+
+// A benchmark has regressed when its median moved past the threshold and also past three times
+// the combined noise of the two runs
+int Benchmark::CompareWithBaseline(const char *pszPath, double threshold)
+{
+    FILE *pFile = fopen(pszPath, "r");
+    if (pFile == nullptr)
+    {
+        printf("Can't open baseline %s\n", pszPath);
+        return 1;
+    }
+
+    int cRegressions = 0;
+    char line[256];
+    printf("\n%-28s %12s %12s %8s\n", "benchmark", "baseline_ns", "current_ns", "change");
+    while (fgets(line, sizeof(line), pFile) != nullptr)
+    {
+        char *pComma = strchr(line, ',');
+        Result baseline;
+        if ((pComma == nullptr) || (pComma - line >= static_cast<int>(sizeof(baseline.name))))
+        {
+            continue;
+        }
+        SDL_strlcpy(baseline.name, line, (pComma - line) + 1);
+        if (sscanf(pComma + 1, "%u,%lf,%lf,%lf", &baseline.cIterations, &baseline.nsMedian, &baseline.nsMin, &baseline.nsMad) != 4)
+        {
+            continue;   // Header
+        }
+
+        for (Uint32 i = 0; i < _cResults; i++)
+        {
+            if (SDL_strcmp(_results[i].name, baseline.name) == 0)
+            {
+                double change = (_results[i].nsMedian - baseline.nsMedian) / baseline.nsMedian;
+                bool fRegressed = (change > threshold) &&
+                    ((_results[i].nsMedian - baseline.nsMedian) > 3 * (_results[i].nsMad + baseline.nsMad));
+                printf("%-28s %12.2f %12.2f %+7.1f%%%s\n", baseline.name, baseline.nsMedian, _results[i].nsMedian,
+                    change * 100, fRegressed ? "  REGRESSED" : "");
+                cRegressions += fRegressed ? 1 : 0;
+            }
+        }
+    }
+    fclose(pFile);
+    return (cRegressions == 0) ? 0 : 1;
+}
+
+int Benchmark::Run(int argc, char **argv)
+{
+    const char *pszOut = nullptr;
+    const char *pszBaseline = nullptr;
+    double threshold = 0.10;
+    for (int i = 1; i < argc; i++)
+    {
+        if ((SDL_strcmp(argv[i], "--out") == 0) && (i + 1 < argc))
+        {
+            pszOut = argv[++i];
+        }
+        else if ((SDL_strcmp(argv[i], "--baseline") == 0) && (i + 1 < argc))
+        {
+            pszBaseline = argv[++i];
+        }
+        else if ((SDL_strcmp(argv[i], "--threshold") == 0) && (i + 1 < argc))
+        {
+            threshold = SDL_atof(argv[++i]) / 100;
+        }
+    }
+
+    // The render benchmarks need SDL_image, the harness does its own SDL setup later
+    if (IMG_Init(IMG_INIT_PNG) == 0)
+    {
+        printf("IMG_Init failed! SDL_image Error: %s\n", IMG_GetError());
+    }
+
+    BenchMaze();
+    BenchGhost();
+    BenchGhostStore();
+    BenchPathHierarchy();
+    BenchSprites();
+    BenchTiledMapRender();
+    BenchOnRunning();
+    BenchBatchEnvironment();
+
+    WriteResults(stdout);
+    if (pszOut != nullptr)
+    {
+        FILE *pFile = fopen(pszOut, "w");
+        if (pFile != nullptr)
+        {
+            WriteResults(pFile);
+            fclose(pFile);
+        }
+        else
+        {
+            printf("Can't write %s\n", pszOut);
+        }
+    }
+
+    return (pszBaseline != nullptr) ? CompareWithBaseline(pszBaseline, threshold) : 0;
+}
+
+int main(int argc, char **argv)
+{
+    Benchmark benchmark;
+    return benchmark.Run(argc, argv);
+}
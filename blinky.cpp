@@ -15,51 +15,31 @@ bool Blinky::Initialize()
     // the specific loading data
     InitializeCommon();
     LoadFrames(0, 0, 64, 8);
-    _scatterRow = Constants::BlinkyScatterRow;
-    _scatterCol = Constants::BlinkyScatterCol;
     _targetColor = Constants::BlinkyDrawColor;
     return true;
 }
 
 bool Blinky::Reset(Maze *pMaze)
 {
+    const MazeLayout &layout = pMaze->Layout();
+    const MazeLayout::Cell &start = layout.ghostStarts[0];
+    _scatterRow = layout.scatterTargets[0].row;
+    _scatterCol = layout.scatterTargets[0].col;
+
     SetAnimation(Constants::AnimationIndexUp);
-    SDL_Point playerStartCoord = pMaze->GetTileCoordinates(Constants::GhostPenRow-3, Constants::GhostPenCol);
+    SDL_Point playerStartCoord = pMaze->GetTileCoordinates(start.row, start.col);
     
     // There is no "penned" mode, just placement will take care of that.  Blinky is the only
     // ghost that is supposed to start outside of the pen, but since he's the only one for now
     // put him inside to test out that code path.
-    _currentRow = Constants::GhostPenRow-3;
-    _currentCol = Constants::GhostPenCol;
+    _currentRow = start.row;
+    _currentCol = start.col;
     ResetPosition(playerStartCoord.x, playerStartCoord.y);
-    SetVelocity(Constants::GhostBaseSpeed * -1.75, 0);
+    SetVelocity(Constants::GhostSpeed * -1, 0);
 
-    SafeDelete<Decision>(_pNextDecision);
-    SafeDelete<Decision>(_pCurrentDecision);
-    _pCurrentDecision = new Decision(Constants::GhostPenRow-3, Constants::GhostPenCol, CurrentDirection());
+    ResetDecisions(start.row, start.col, CurrentDirection());
     _penTimer.Reset();
     _mode = Mode::Chase;
     _fScatter = false;
     return true;
-}
-
-Direction Blinky::MakeBranchDecision(Uint16 nRow, Uint16 nCol, Player* pPlayer, Maze *pMaze)
-{
-    // Blinky's target tile is the player's current tile
-    // We won't bother with "Elroy" states at the moment
-    Direction result = CurrentDirection();
-
-    // The "next" cell is already passed in here, given this location, find the branch
-    // That brings us closest to the target cell (the player)
-    SDL_Point playerPoint = { static_cast<int>(pPlayer->X()), static_cast<int>(pPlayer->Y()) };
-    if (_fScatter)
-    {
-        _targetRow = _scatterRow;
-        _targetCol = _scatterCol;
-    }
-    else
-    {
-        pMaze->GetTileRowCol(playerPoint, _targetRow, _targetCol);
-    }
-    return ShortestDirectionToTarget(nRow, nCol, _targetRow, _targetCol, pMaze);
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "include/constants.h"
+#include "include/mazeattributes.h"
+#include "include/pelletboard.h"
 
 namespace XplatGameTutorial
 {
@@ -15,11 +17,104 @@ namespace PacManClone
     
     const char * const Constants::WindowTitle = "Pac-Man Clone";
 
-    const double Constants::PlayerMaxSpeed = 2.0;
-    const double Constants::GhostBaseSpeed = 0.75;
+
+namespace
+{
+    // Compile time table generation.  This has to stay within C++11 constexpr rules (a single return
+    // expression, recursion instead of loops) so the tables are built by expanding a pack of indices
+    // into an aggregate initializer, one constexpr call per entry.
+    template <size_t... Indices>
+    struct IndexList
+    {
+    };
+
+    template <typename First, typename Second>
+    struct ConcatIndexLists;
+
+    template <size_t... First, size_t... Second>
+    struct ConcatIndexLists<IndexList<First...>, IndexList<Second...>>
+    {
+        typedef IndexList<First..., (sizeof...(First) + Second)...> Type;
+    };
+
+    // Built by halves so the template depth stays small for big tables
+    template <size_t N>
+    struct MakeIndexList
+    {
+        typedef typename ConcatIndexLists<typename MakeIndexList<N / 2>::Type, typename MakeIndexList<N - (N / 2)>::Type>::Type Type;
+    };
+
+    template <>
+    struct MakeIndexList<0>
+    {
+        typedef IndexList<> Type;
+    };
+
+    template <>
+    struct MakeIndexList<1>
+    {
+        typedef IndexList<0> Type;
+    };
+
+    template <typename T, size_t N>
+    struct Table
+    {
+        T values[N];
+    };
+
+    // Generator::Value(i) provides each entry
+    template <typename Generator, typename T, size_t N, size_t... Indices>
+    constexpr Table<T, N> MakeTable(IndexList<Indices...>)
+    {
+        return { { Generator::Value(Indices)... } };
+    }
+
+    template <typename Generator, typename T, size_t N>
+    constexpr Table<T, N> MakeTable()
+    {
+        return MakeTable<Generator, T, N>(typename MakeIndexList<N>::Type());
+    }
+
+    // Taylor series, only ever called with |x| <= pi where 30 terms is well past double precision
+    constexpr double c_pi = 3.14159265358979323846;
+
+    constexpr double SeriesSum(double xSquared, double term, int n, int cTerms)
+    {
+        return (cTerms == 0) ? 0.0 : term + SeriesSum(xSquared, -term * xSquared / ((n + 1) * (n + 2)), n + 2, cTerms - 1);
+    }
+
+    constexpr double ReduceAngle(double x)
+    {
+        return ((x - (2 * c_pi * static_cast<long long>(x / (2 * c_pi)))) > c_pi) ?
+            (x - (2 * c_pi * static_cast<long long>(x / (2 * c_pi)))) - (2 * c_pi) :
+            (x - (2 * c_pi * static_cast<long long>(x / (2 * c_pi))));
+    }
+
+    constexpr double Cosine(double x)
+    {
+        return SeriesSum(ReduceAngle(x) * ReduceAngle(x), 1.0, 0, 30);
+    }
+
+    constexpr double Sine(double x)
+    {
+        return SeriesSum(ReduceAngle(x) * ReduceAngle(x), ReduceAngle(x), 1, 30);
+    }
+
+    struct CosineGenerator
+    {
+        static constexpr double Value(size_t i) { return Cosine(i / 4.0); }
+    };
+
+    struct SineGenerator
+    {
+        static constexpr double Value(size_t i) { return Sine(i / 4.0); }
+    };
+
+    constexpr Table<double, Constants::TrigTableSize> c_cosineTable = MakeTable<CosineGenerator, double, Constants::TrigTableSize>();
+    constexpr Table<double, Constants::TrigTableSize> c_sineTable = MakeTable<SineGenerator, double, Constants::TrigTableSize>();
 
     // This is the map data for the tiles, each index represents a different tile to render
-    Uint16 Constants::MapIndicies[MapRows * MapCols] =
+    constexpr Uint16 c_mapIndicies[Constants::MapRows * Constants::MapCols] =
     {
         49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49,
         49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 49,
@@ -61,7 +156,7 @@ namespace PacManClone
 
     // Like the tilemap, this represents the playing area, but 1s are illegal space and 0s are legal free space
     // for the player.  The player sprite should be confined to these cells
-    Uint16 Constants::CollisionMap[MapRows * MapCols] =
+    constexpr Uint16 c_collisionMap[Constants::MapRows * Constants::MapCols] =
     { //          5       910    13
         1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,  //00
         1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
@@ -101,29 +196,105 @@ namespace PacManClone
         1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1
     };
 
-    double Constants::CosineTable[1440] = {};
-    double Constants::SineTable[1440] = {};
+    constexpr MazeLayout::Region c_pen =
+        { Constants::GhostPenRowTop, Constants::GhostPenColLeft, Constants::GhostPenRowBottom, Constants::GhostPenColRight };
+
+    constexpr MazeLayout::WarpPair c_warps[] =
+    {
+        { { Constants::WarpRow, 0 }, { Constants::WarpRow, Constants::MapCols - 1 } }
+    };
+
+    struct MapAttributesGenerator
+    {
+        static constexpr Uint16 Value(size_t i)
+        {
+            return MazeAttributes::ForTile(c_collisionMap, c_mapIndicies, Constants::MapRows, Constants::MapCols,
+                static_cast<int>(i / Constants::MapCols), static_cast<int>(i % Constants::MapCols), c_pen,
+                (i / Constants::MapCols) == Constants::WarpRow);
+        }
+    };
+
+    constexpr Table<Uint16, Constants::MapRows * Constants::MapCols> c_mapAttributes =
+        MakeTable<MapAttributesGenerator, Uint16, Constants::MapRows * Constants::MapCols>();
+
+    // The starting pellets as the maze keeps them, the pellet words then the power pellet words
+    constexpr size_t c_cMapTiles = Constants::MapRows * Constants::MapCols;
+    constexpr size_t c_cMapPelletWords = PelletBoard::WordsFor(c_cMapTiles);
+
+    struct MapPelletsGenerator
+    {
+        static constexpr Uint64 Bits(Uint16 mask, size_t word, size_t bit)
+        {
+            return (bit == 64) ? 0 :
+                ((((word * 64) + bit < c_cMapTiles) && ((c_mapAttributes.values[(word * 64) + bit] & mask) != 0)) ? (static_cast<Uint64>(1) << bit) : 0) |
+                Bits(mask, word, bit + 1);
+        }
+
+        static constexpr Uint64 Value(size_t i)
+        {
+            return (i < c_cMapPelletWords) ? Bits(MazeAttributes::Pellet, i, 0) : Bits(MazeAttributes::PowerPellet, i - c_cMapPelletWords, 0);
+        }
+    };
+
+    constexpr Table<Uint64, 2 * c_cMapPelletWords> c_mapPellets = MakeTable<MapPelletsGenerator, Uint64, 2 * c_cMapPelletWords>();
+}
+
+    const Uint16 (&Constants::MapIndicies)[MapRows * MapCols] = c_mapIndicies;
+    const Uint16 (&Constants::CollisionMap)[MapRows * MapCols] = c_collisionMap;
+    const Uint16 (&Constants::MapAttributes)[MapRows * MapCols] = c_mapAttributes.values;
+    const MazeLayout Constants::ClassicMaze =
+    {
+        MapRows,
+        MapCols,
+        c_mapIndicies,
+        c_collisionMap,
+        c_mapAttributes.values,
+        TotalPellets,
+        c_mapPellets.values,
+        c_mapPellets.values + c_cMapPelletWords,
+        { PlayerStartRow, PlayerStartCol },
+        {
+            { GhostPenRowExit, GhostPenCol },       // Blinky starts outside
+            { GhostPenRow, GhostPenCol + 2 },
+            { GhostPenRow, GhostPenCol - 2 },
+            { GhostPenRow, GhostPenCol + 1 }
+        },
+        {
+            { BlinkyScatterRow, BlinkyScatterCol },
+            { PinkyScatterRow, PinkyScatterCol },
+            { InkyScatterRow, InkyScatterCol },
+            { ClydeScatterRow, ClydeScatterCol }
+        },
+        c_pen,
+        { GhostPenRowExit, GhostPenCol },
+        c_warps,
+        SDL_arraysize(c_warps)
+    };
+    const double (&Constants::CosineTable)[TrigTableSize] = c_cosineTable.values;
+    const double (&Constants::SineTable)[TrigTableSize] = c_sineTable.values;
 
     // Vaious animation sequences, these are index to frames on the sprite sheet
-    int Constants::PlayerAnimation_UP[PlayerAnimationFrameCount] = { 0, 1, 2, 1 };
-    int Constants::PlayerAnimation_DOWN[PlayerAnimationFrameCount] = { 0, 5, 6, 5 };
-    int Constants::PlayerAnimation_LEFT[PlayerAnimationFrameCount] = { 0, 7, 8, 7 };
-    int Constants::PlayerAnimation_RIGHT[PlayerAnimationFrameCount] = { 0, 3, 4, 3 };
-    int Constants::PlayerAnimation_DEATH[PlayerAnimationDeathFrameCount] = { 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 9 };
-
-
-    int Constants::GhostAnimation_UP[GhostMovingAnimationFrameCount] = { 0, 1 };
-    int Constants::GhostAnimation_DOWN[GhostMovingAnimationFrameCount] = { 2, 3 };
-    int Constants::GhostAnimation_LEFT[GhostMovingAnimationFrameCount] = { 4, 5 };
-    int Constants::GhostAnimation_RIGHT[GhostMovingAnimationFrameCount] = { 6, 7 };
-    int Constants::GhostAnimation_FRIGHT[GhostMovingAnimationFrameCount] = { 8, 9 };
-    int Constants::GhostAnimation_SCARED[GhostScaredAnimationFrameCount] = { 8, 11, 9, 10};
-    int Constants::GhostAnimation_DEATHUP[GhostMovingAnimationFrameCount] = { 12, 12 };     // Placeholder for frames
-    int Constants::GhostAnimation_DEATHDOWN[GhostMovingAnimationFrameCount] = { 13, 13 };
-    int Constants::GhostAnimation_DEATHLEFT[GhostMovingAnimationFrameCount] = { 14, 14 };
-    int Constants::GhostAnimation_DEATHRIGHT[GhostMovingAnimationFrameCount] = {15, 15 };
+    const int Constants::PlayerAnimation_UP[PlayerAnimationFrameCount] = { 0, 1, 2, 1 };
+    const int Constants::PlayerAnimation_DOWN[PlayerAnimationFrameCount] = { 0, 5, 6, 5 };
+    const int Constants::PlayerAnimation_LEFT[PlayerAnimationFrameCount] = { 0, 7, 8, 7 };
+    const int Constants::PlayerAnimation_RIGHT[PlayerAnimationFrameCount] = { 0, 3, 4, 3 };
+    const int Constants::PlayerAnimation_DEATH[PlayerAnimationDeathFrameCount] = { 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 9 };
+
+
+    const int Constants::GhostAnimation_UP[GhostMovingAnimationFrameCount] = { 0, 1 };
+    const int Constants::GhostAnimation_DOWN[GhostMovingAnimationFrameCount] = { 2, 3 };
+    const int Constants::GhostAnimation_LEFT[GhostMovingAnimationFrameCount] = { 4, 5 };
+    const int Constants::GhostAnimation_RIGHT[GhostMovingAnimationFrameCount] = { 6, 7 };
+    const int Constants::GhostAnimation_FRIGHT[GhostMovingAnimationFrameCount] = { 8, 9 };
+    const int Constants::GhostAnimation_SCARED[GhostScaredAnimationFrameCount] = { 8, 11, 9, 10};
+    const int Constants::GhostAnimation_DEATHUP[GhostMovingAnimationFrameCount] = { 12, 12 };     // Placeholder for frames
+    const int Constants::GhostAnimation_DEATHDOWN[GhostMovingAnimationFrameCount] = { 13, 13 };
+    const int Constants::GhostAnimation_DEATHLEFT[GhostMovingAnimationFrameCount] = { 14, 14 };
+    const int Constants::GhostAnimation_DEATHRIGHT[GhostMovingAnimationFrameCount] = {15, 15 };
     const char * const Constants::TilesImage = "./grfx/tiles.png";
     const char * const Constants::SpritesImage = "./grfx/spritesheet.png";
     const char * const Constants::TitleImage = "./grfx/pmctitle.png";
+    const char * const Constants::AssetPackFile = "./grfx/assets.pmca";
+    const char * const Constants::ProfileCsvFile = "profile.csv";
 }
 };
\ No newline at end of file
@@ -2,47 +2,41 @@
 
 using namespace XplatGameTutorial::PacManClone;
 
-// TEMP compile time flags for ghost enabling
-#define GHOST_BLINKY
-#define GHOST_PINKY
-#define GHOST_INKY
-#define GHOST_CLYDE
-
-// requires Blinky so make sure we enabled it
-// will crash otherwise
-#ifdef GHOST_INKY
-#ifndef GHOST_BLINKY
-#define GHOST_BLINKY
-#endif
-#endif
-
-// Duplicated code based on class type - perfect for a template function
-// This creates an object if it does not already exist, and in all cases
-// will Reset() the object
-template <class T> void InitGameSprite(T** p, TextureWrapper* pTexture, Maze* pMaze)
-{
-    if (*p == nullptr)
-    {
-        *p = new T(pTexture);
-        (*p)->Initialize();
-    }
-    (*p)->Reset(pMaze);
-}
-
 // Start up SDL and load our textures - the stuff we'll need for the entire process lifetime
-SDL_bool GameHarness::Initialize()
+SDL_bool GameHarness::Initialize(bool fHeadless, Uint32 cMaxFrames)
 {
     SDL_assert(_fInitialized == false);
     SDL_bool result = SDL_FALSE;
-    if (InitializeSDL(&_pSDLWindow, &_pSDLRenderer) == SDL_TRUE)
-    {
-        // Load our textures
-        SDL_Color colorKey = Constants::SDLColorMagenta;
-        _pTilesTexture = new TextureWrapper(Constants::TilesImage, SDL_strlen(Constants::TilesImage), _pSDLRenderer, nullptr);
-        _pSpriteTexture = new TextureWrapper(Constants::SpritesImage, SDL_strlen(Constants::SpritesImage), _pSDLRenderer, &colorKey);
-        _pTitleTexture = new TextureWrapper(Constants::TitleImage, SDL_strlen(Constants::TitleImage), _pSDLRenderer, nullptr);
+    _fHeadless = fHeadless;
+    _cMaxFrames = cMaxFrames;
 
-        if (_pTilesTexture->IsNull() || _pSpriteTexture->IsNull() || _pTitleTexture->IsNull())
+    if (_fHeadless)
+    {
+        if (InitializeSDLHeadless())
+        {
+            // Nothing is drawn, but the sprites and maze still validate their rects against
+            // the texture sizes, so hand them placeholders
+            _pTilesTexture = new TextureWrapper(Constants::TileTextureWidth, Constants::TileTextureHeight);
+            _pSpriteTexture = new TextureWrapper(Constants::SpriteTextureWidth, Constants::SpriteTextureHeight);
+            _pTitleTexture = new TextureWrapper(Constants::ScreenWidth, Constants::ScreenHeight);
+            _fInitialized = true;
+            result = SDL_TRUE;
+        }
+    }
+    else if (InitializeSDL(&_pSDLWindow, &_pSDLRenderer) == SDL_TRUE)
+    {
+        // Only the title is loaded before the first frame, straight from the baked asset pack if
+        // there is one.  The tiles and sprites start out as placeholders and stream in behind the
+        // title screen (see Run), the simulation only needs their sizes until the level is loaded
+        _loader.Initialize(Constants::AssetPackFile);
+        _pTitleTexture = _loader.LoadNow(Constants::TitleImage, nullptr, _pSDLRenderer);
+        _pTilesTexture = new TextureWrapper(Constants::TileTextureWidth, Constants::TileTextureHeight);
+        _pSpriteTexture = new TextureWrapper(Constants::SpriteTextureWidth, Constants::SpriteTextureHeight);
+
+        if (_pTitleTexture->IsNull() ||
+            !_loader.Add(Constants::TilesImage, false, _pTilesTexture) ||
+            !_loader.Add(Constants::SpritesImage, true, _pSpriteTexture) ||
+            !_loader.Start())
         {
             printf("Failed to load one or more textures\n");
         }
@@ -52,104 +46,295 @@ SDL_bool GameHarness::Initialize()
             result = SDL_TRUE;
         }
     }
+
+    if (result == SDL_TRUE)
+    {
+        _simulation.Initialize(_pTilesTexture, _pSpriteTexture, &_clock);
+    }
     return result;
 }
 
-// Main loop, process window messages and dispatch to the current GameState handler
+bool GameHarness::LoadMaze(const char *pszPath, Uint32 iMaze)
+{
+    // Kept for recordings
+    if (SDL_strlen(pszPath) >= SDL_arraysize(_options.szMazePath))
+    {
+        printf("GameHarness::LoadMaze() : %s is too long a path\n", pszPath);
+        return false;
+    }
+
+    if (!_mazePack.Open(pszPath))
+    {
+        return false;
+    }
+    if (!_mazePack.GetLayout(iMaze, &_mazeLayout, _fVerifyMaze))
+    {
+        _mazePack.Close();
+        return false;
+    }
+    _simulation.SetLayout(&_mazeLayout);
+    SDL_strlcpy(_options.szMazePath, pszPath, SDL_arraysize(_options.szMazePath));
+    _options.iMaze = iMaze;
+    return true;
+}
+
+bool GameHarness::PlayReplay(const char *pszPath)
+{
+    _fReplayFailed = !_replay.StartPlayback(pszPath);
+    if (_fReplayFailed)
+    {
+        return false;
+    }
+
+    // Play the game the recording did whatever we were started with, a maze can only be picked
+    // once though
+    const InputReplay::Options &recorded = _replay.RecordedOptions();
+    EnableTruePathing(recorded.fTruePathing);
+    EnableCrowd(recorded.cCrowdGhosts);
+    if ((SDL_strcmp(recorded.szMazePath, _options.szMazePath) != 0) || (recorded.iMaze != _options.iMaze))
+    {
+        if (_options.szMazePath[0] != '\0')
+        {
+            if (recorded.szMazePath[0] != '\0')
+            {
+                printf("%s was recorded on maze %u of %s\n", pszPath, recorded.iMaze, recorded.szMazePath);
+            }
+            else
+            {
+                printf("%s was recorded on the classic maze\n", pszPath);
+            }
+            _fReplayFailed = true;
+        }
+        else
+        {
+            _fReplayFailed = !LoadMaze(recorded.szMazePath, recorded.iMaze);
+        }
+    }
+
+    if (_fReplayFailed)
+    {
+        _replay.StopPlayback();
+        return false;
+    }
+    return true;
+}
+
+// Main loop, process window messages and advance the simulation in fixed steps, rendering once per pass
 void GameHarness::Run()
 {
     SDL_assert(_fInitialized);
-    static bool fQuit = false;
+    bool fQuit = false;
     SDL_Event eventSDL;
 
-    Uint32 startTicks;
+    // Fixed timestep - the simulation always advances in exact 1/FramesPerSecond steps however fast or
+    // slow we render.  Elapsed time is accumulated in performance counter units scaled by the tick rate,
+    // so one tick costs exactly one counter frequency and nothing is lost to rounding
+    const Uint64 counterFrequency = SDL_GetPerformanceFrequency();
+    Uint64 lastCounter = SDL_GetPerformanceCounter();
+    Uint64 reportCounter = lastCounter;
+    Uint64 accumulator = 0;
+    Uint32 cTicksCaughtUp = 0;
+    Uint32 cTicksDropped = 0;
+    Uint32 cTicks = 0;
+    Uint32 runStartTicks = SDL_GetTicks();
+
     while (!fQuit)
     {
-        startTicks = SDL_GetTicks();
         while (SDL_PollEvent(&eventSDL) != 0)
         {
             if (eventSDL.type == SDL_QUIT)
             {
                 fQuit = true;
             }
+            else if ((eventSDL.type == SDL_RENDER_TARGETS_RESET) && (_simulation.GetMaze() != nullptr))
+            {
+                // Render target contents were lost, the cached maze has to be redrawn
+                _simulation.GetMaze()->InvalidateCache();
+            }
+            else if ((eventSDL.type == SDL_KEYDOWN) && (eventSDL.key.repeat == 0) &&
+                (eventSDL.key.keysym.scancode == SDL_SCANCODE_F1))
+            {
+                _profiler.ToggleOverlay();
+            }
         }
 
         if (!fQuit)
         {
-            switch (_state)
+            if (_fHeadless)
+            {
+                // Uncapped, exactly one tick per pass and nothing to draw
+                fQuit = !UpdateState();
+                _profiler.CommitFrame();
+                cTicks++;
+            }
+            else if (_loader.IsLoading())
             {
-            case GameState::Title:
-                Direction inputDirection;
-                if (ProcessInput(&inputDirection))
+                // Still on the title while the rest of the textures come in.  No ticks run until
+                // they're all up, so the game (and any replay) is the same however long it takes
+                if (!_loader.UploadSlice(_pSDLRenderer))
                 {
-                    _state = GameState::Exiting;
+                    printf("Failed to load one or more textures\n");
+                    fQuit = true;
                 }
-                else if (inputDirection != Direction::None)
+                Render();
+                _profiler.CommitFrame();
+                lastCounter = SDL_GetPerformanceCounter();
+                SDL_Delay(1000 / Constants::FramesPerSecond);
+            }
+            else
+            {
+                Uint64 nowCounter = SDL_GetPerformanceCounter();
+                accumulator += (nowCounter - lastCounter) * Constants::FramesPerSecond;
+                lastCounter = nowCounter;
+
+                // Zero or more ticks this frame depending on how much time has built up
+                Uint32 cTicksThisFrame = 0;
+                while ((accumulator >= counterFrequency) && !fQuit)
                 {
-                    _state = GameState::WaitingToStartLevel;
+                    if (cTicksThisFrame == Constants::MaxTicksPerFrame)
+                    {
+                        // Too far behind (stalled in a debugger, window being dragged...) so throw the
+                        // rest away rather than spiral trying to catch up
+                        cTicksDropped += static_cast<Uint32>(accumulator / counterFrequency);
+                        accumulator %= counterFrequency;
+                        break;
+                    }
+                    fQuit = !UpdateState();
+                    accumulator -= counterFrequency;
+                    cTicksThisFrame++;
+                    cTicks++;
                 }
-                break;
-            case GameState::LoadingResources:
-                // Loads the current maze and the sprites if needed
-                _state = OnLoading();
-                break;
-            case GameState::WaitingToStartLevel:
-                // Small delay before level starts
-                _state = OnWaitingToStartLevel();
-                break;
-            case GameState::Running:
-                // Normal gameplay
-                _state = OnRunning();
-                break;
-            case GameState::PlayerDying:
-                // Death animation, skip for now since no ghosts
-                _state = GameState::WaitingToStartLevel;
-                break;
-            case GameState::LevelComplete:
-                // Flashing level animation
-                _state = OnLevelComplete();
-                break;
-            case GameState::GameOver:
-                // Final drawing of level, score, etc
-                break;
-            case GameState::Exiting:
-                fQuit = true;
-                break;
-            }
 
-            // Draw the current frame
-            Render();
+                if (cTicksThisFrame > 1)
+                {
+                    cTicksCaughtUp += cTicksThisFrame - 1;
+                }
+
+                // Draw the current frame
+                Render();
+                _profiler.CommitFrame();
 
-            // TIMING
-            // Fix this at ~c_framesPerSecond
-            Uint32 endTicks = SDL_GetTicks();
-            Uint32 elapsedTicks = endTicks - startTicks;
-            if (elapsedTicks < Constants::TicksPerFrame)
+                // Once a second let us know if the loop is struggling to keep up
+                if (nowCounter - reportCounter >= counterFrequency)
+                {
+                    if ((cTicksCaughtUp != 0) || (cTicksDropped != 0))
+                    {
+                        printf("Timing: %u ticks caught up, %u ticks dropped in the last second\n", cTicksCaughtUp, cTicksDropped);
+                    }
+                    cTicksCaughtUp = 0;
+                    cTicksDropped = 0;
+                    reportCounter = nowCounter;
+                }
+
+                // Sleep off what's left until the next tick is due.  SDL_Delay only has ms granularity
+                // (and often worse) so wake a little early and let the accumulator absorb the rest
+                Uint64 remaining = (counterFrequency - (accumulator % counterFrequency)) / Constants::FramesPerSecond;
+                Uint32 msRemaining = static_cast<Uint32>((remaining * 1000) / counterFrequency);
+                if (msRemaining > 1)
+                {
+                    SDL_Delay(msRemaining - 1);
+                }
+            }
+
+            if ((_cMaxFrames != 0) && (cTicks >= _cMaxFrames))
             {
-                SDL_Delay(Constants::TicksPerFrame - elapsedTicks);
+                fQuit = true;
             }
         }
     }
 
+    if (_fHeadless)
+    {
+        Uint32 runTicks = SDL_GetTicks() - runStartTicks;
+        printf("Headless run complete: %u frames in %u ms\n", cTicks, runTicks);
+#ifndef NDEBUG
+        printf("%u heap allocations in the update path this level\n", _cUpdateAllocations);
+#endif
+    }
+
+    // The recording ends on the tick the game quits, so does the playback and UpdateState never
+    // gets to see it's done
+    if (_replay.IsPlaying())
+    {
+        _fReplayFailed = !_replay.FinishPlayback(StateChecksum());
+    }
+    _replay.StopRecording(StateChecksum());
+    _profiler.WriteCsv(Constants::ProfileCsvFile);
+
     // cleanup
     Cleanup();
 }
 
+// Advance the game by a single simulation tick, dispatching to the current GameState handler
+// Returns false once the game should exit
+bool GameHarness::UpdateState()
+{
+    bool fContinue = true;
+    if (_replay.IsPlaybackDone())
+    {
+        // Same number of ticks as the recording, we should be in exactly the same place
+        _fReplayFailed = !_replay.FinishPlayback(StateChecksum());
+        return false;
+    }
+    _replay.Tick();
+    _clock.Tick();
+
+    switch (_state)
+    {
+    case GameState::Title:
+        Direction inputDirection;
+        if (_replay.IsPlaying() ? _replay.AutoStart() : _fHeadless)
+        {
+            // Nobody to press a key, go straight to the game
+            _state = GameState::WaitingToStartLevel;
+        }
+        else if (ProcessInput(&inputDirection))
+        {
+            _state = GameState::Exiting;
+        }
+        else if (inputDirection != Direction::None)
+        {
+            _state = GameState::WaitingToStartLevel;
+        }
+        break;
+    case GameState::LoadingResources:
+        // Loads the current maze and the sprites if needed
+        _state = OnLoading();
+        break;
+    case GameState::WaitingToStartLevel:
+        // Small delay before level starts
+        _state = OnWaitingToStartLevel();
+        break;
+    case GameState::Running:
+        // Normal gameplay
+        _state = OnRunning();
+        break;
+    case GameState::PlayerDying:
+        // Death animation, skip for now since no ghosts
+        _state = GameState::WaitingToStartLevel;
+        break;
+    case GameState::LevelComplete:
+        // Flashing level animation
+        _state = OnLevelComplete();
+        break;
+    case GameState::GameOver:
+        // Final drawing of level, score, etc
+        break;
+    case GameState::Exiting:
+        fContinue = false;
+        break;
+    }
+    return fContinue;
+}
+
 void GameHarness::Cleanup()
 {
     SDL_assert(_fInitialized);
+    _loader.Cleanup();
+    _simulation.Cleanup();
     SafeDelete<TextureWrapper>(_pTitleTexture);
     SafeDelete<TextureWrapper>(_pTilesTexture);
     SafeDelete<TextureWrapper>(_pSpriteTexture);
-    SafeDelete<Maze>(_pMaze);
-    SafeDelete<Player>(_pPlayer);
-    SafeDelete<Blinky>(_pBlinky);
-    SafeDelete<Pinky>(_pPinky);
-    SafeDelete<Inky>(_pInky);
-    SafeDelete<Clyde>(_pClyde);
-
-    // The _pGhosts array just holds references to deleted
-    // objects, no need to free them
 
     SDL_DestroyRenderer(_pSDLRenderer);
     _pSDLRenderer = nullptr;
@@ -162,44 +347,32 @@ void GameHarness::Cleanup()
     _fInitialized = false;
 }
 
-void GameHarness::InitializeSprites()
+// Record key presses we care about
+// returns true if we need to exit
+// All the game's input comes through here, so this is where it's recorded or played back
+bool GameHarness::ProcessInput(Direction *pInputDirection)
 {
-    // In all cases we create a player
-    SDL_assert(_fInitialized);
-    InitGameSprite(&_pPlayer, _pSpriteTexture, _pMaze);
-
-    // The ghosts are controlled by these flags
-#ifdef GHOST_BLINKY
-    InitGameSprite(&_pBlinky, _pSpriteTexture, _pMaze);
-    _pGhosts[0] = _pBlinky;
-#endif
-
-#ifdef GHOST_PINKY
-    InitGameSprite(&_pPinky, _pSpriteTexture, _pMaze);
-    _pGhosts[1] = _pPinky;
-#endif
-
-    // Will also enable blinky as he is needed for Inky's
-    // targeting scheme
-#ifdef GHOST_INKY
-    InitGameSprite(&_pInky, _pSpriteTexture, _pMaze);
-    _pInky->SetBlinkyReference(_pBlinky);
-    _pGhosts[2] = _pInky;
-#endif
+    if (_replay.IsPlaying())
+    {
+        return _replay.ReadInput(pInputDirection);
+    }
 
-#ifdef GHOST_CLYDE
-    InitGameSprite(&_pClyde, _pSpriteTexture, _pMaze);
-    _pGhosts[3] = _pClyde;
-#endif
+    bool fQuit = ReadKeyboard(pInputDirection);
+    _replay.WriteInput(*pInputDirection, fQuit);
+    return fQuit;
 }
 
-// Record key presses we care about
-// returns true if we need to exit
-bool GameHarness::ProcessInput(Direction *pInputDirection)
+bool GameHarness::ReadKeyboard(Direction *pInputDirection)
 {
     *pInputDirection = Direction::None;
     bool fResult = false;
 
+    // No keyboard without the video subsystem
+    if (_fHeadless)
+    {
+        return fResult;
+    }
+
     // All it takes to get the key states.  The array is valid within SDL while running
     const Uint8 *pCurrentKeyState = SDL_GetKeyboardState(nullptr);
 
@@ -227,68 +400,60 @@ bool GameHarness::ProcessInput(Direction *pInputDirection)
     return fResult;
 }
 
-// Detect if the player has entered a pellet tile and remove it, incrementing our counter
-// If the pellet is BIG, then trigger the ghost behavior
-Uint16 GameHarness::HandlePelletCollision()
+// Hash of where everything is, to check a replay ends up where its recording did
+Uint64 GameHarness::StateChecksum()
 {
-    Uint16 ret = 0;
-    SDL_Point playerPoint = { static_cast<int>(_pPlayer->X()), static_cast<int>(_pPlayer->Y()) };
-    Uint16 row = 0;
-    Uint16 col = 0;
-    _pMaze->GetTileRowCol(playerPoint, row, col);
-
-    if (_pMaze->IsTilePellet(row, col))
+    Uint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void *pData, size_t cb)
     {
-        _pMaze->EatPellet(row, col);
-        ret++;
-    }
-    else if (_pMaze->IsTilePowerPellet(row, col))
-    {
-        _pMaze->EatPellet(row, col);
-        ret++;
-
-        for (size_t i = 0; i < SDL_arraysize(_pGhosts); i++)
+        const Uint8 *pBytes = static_cast<const Uint8 *>(pData);
+        for (size_t i = 0; i < cb; i++)
         {
-            if (_pGhosts[i] != nullptr)
-            {
-                _pGhosts[i]->OnPowerPelletEaten(_pMaze);
-            }
+            hash = (hash ^ pBytes[i]) * 1099511628211ULL;
         }
-    }
-    return ret;
-}
+    };
 
-// Detect if the player has collided with a ghost (i.e. they are in the 
-// same cell during the same frame) and handle it based on state (whether
-// the player has an active power pellet)
-GameHarness::GameState GameHarness::HandleGhostCollision()
-{
-    GameState result = GameState::Running;
+    Uint32 state = static_cast<Uint32>(_state);
+    mix(&state, sizeof(state));
+    Uint32 ticks = _clock.Ticks();
+    mix(&ticks, sizeof(ticks));
 
-    Uint16 ret = 0;
-    SDL_Point playerPoint = { static_cast<int>(_pPlayer->X()), static_cast<int>(_pPlayer->Y()) };
-    Uint16 row = 0;
-    Uint16 col = 0;
-    _pMaze->GetTileRowCol(playerPoint, row, col);
-    for (size_t i = 0; i < SDL_arraysize(_pGhosts); i++)
+    Sprite *pSprites[] = { _simulation.GetPlayer(), _simulation.GetGhost(0), _simulation.GetGhost(1),
+        _simulation.GetGhost(2), _simulation.GetGhost(3) };
+    for (size_t i = 0; i < SDL_arraysize(pSprites); i++)
     {
-        if (_pGhosts[i] != nullptr)
+        if (pSprites[i] != nullptr)
         {
-            SDL_Point ghostPoint = { static_cast<int>(_pGhosts[i]->X()), static_cast<int>(_pGhosts[i]->Y()) };
-            Uint16 ghostRow = 0;
-            Uint16 ghostCol = 0;
-            _pMaze->GetTileRowCol(ghostPoint, ghostRow, ghostCol);
-
-            if (ghostRow == row && ghostCol == col)
-            {
-                if (_pGhosts[i]->OnPlayerCollision())
-                {
-                    result = GameState::PlayerDying;
-                }
-            }
+            Fixed position[] = { pSprites[i]->FixedX(), pSprites[i]->FixedY(), pSprites[i]->DX(), pSprites[i]->DY() };
+            mix(position, sizeof(position));
         }
     }
-    return result;
+    return hash;
+}
+
+// The simulation fills in most of it, we add the state machine around it
+void GameHarness::SaveSnapshot(GameSnapshot *pSnapshot)
+{
+    _simulation.Save(pSnapshot);
+    pSnapshot->state = static_cast<Uint8>(_state);
+    _levelStartTimer.Save(&pSnapshot->levelStartTimer);
+    _levelCompleteTimer.Save(&pSnapshot->levelCompleteTimer);
+    pSnapshot->cLevelCompleteFrames = _cLevelCompleteFrames;
+    pSnapshot->fLevelCompleteFlip = _fLevelCompleteFlip;
+}
+
+void GameHarness::RestoreSnapshot(const GameSnapshot &snapshot)
+{
+    _simulation.Restore(snapshot);
+    _state = static_cast<GameState>(snapshot.state);
+    _levelStartTimer.Restore(snapshot.levelStartTimer);
+    _levelCompleteTimer.Restore(snapshot.levelCompleteTimer);
+    _cLevelCompleteFrames = snapshot.cLevelCompleteFrames;
+    _fLevelCompleteFlip = snapshot.fLevelCompleteFlip;
+
+    // The maze tint is only set while the level complete flash runs
+    bool fTinted = (_state == GameState::LevelComplete) && _fLevelCompleteFlip;
+    _simulation.GetMaze()->SetColorMod(255, 255, fTinted ? 100 : 255);
 }
 
 // Tell our object to draw (render their current texture to the renderer)
@@ -296,7 +461,8 @@ void GameHarness::Render()
 {
     SDL_RenderClear(_pSDLRenderer);
 
-    if (_state == GameState::Title)
+    // The title is also up while everything else is loading
+    if ((_state == GameState::Title) || (_state == GameState::LoadingResources))
     {
         if (_pTitleTexture != nullptr)
         {
@@ -307,47 +473,78 @@ void GameHarness::Render()
                 nullptr);
         }
     }
-    else
+    else if (_simulation.GetMaze() != nullptr)
     {
-        if (_pMaze != nullptr)
+        // Big mazes scroll to keep the player in the middle, anything out of view isn't drawn
+        Maze *pMaze = _simulation.GetMaze();
+        if (_simulation.GetPlayer() != nullptr)
         {
-            _pMaze->Render(_pSDLRenderer);
+            pMaze->CenterViewOn(_simulation.GetPlayer()->X(), _simulation.GetPlayer()->Y());
         }
+        SDL_Rect view = pMaze->ViewRect();
+        SDL_Rect clipRect = pMaze->GetScreenBounds();
+        SDL_RenderSetClipRect(_pSDLRenderer, &clipRect);
 
-        if (_pPlayer != nullptr)
         {
-            _pPlayer->Render(_pSDLRenderer);
+            Profiler::Scope scope(_profiler, Profiler::Phase::MazeRender);
+            pMaze->Render(_pSDLRenderer);
+        }
+
+        if (_simulation.GetPlayer() != nullptr)
+        {
+            Profiler::Scope scope(_profiler, Profiler::Phase::SpriteRender);
+            _simulation.GetPlayer()->Render(_pSDLRenderer, view);
         }
 
         // This is common, so loop through our array
-        for (size_t i = 0; i < SDL_arraysize(_pGhosts); i++)
+        for (size_t i = 0; i < Blackboard::c_maxGhosts; i++)
+        {
+            if (_simulation.GetGhost(i) != nullptr)
+            {
+                {
+                    Profiler::Scope scope(_profiler, Profiler::Phase::SpriteRender);
+                    _simulation.GetGhost(i)->Render(_pSDLRenderer, view);
+                }
+                Profiler::Scope scope(_profiler, Profiler::Phase::AITargetRender);
+                RenderAITargets(i, view);
+            }
+        }
+
+        // The crowd borrow the look of the classic ghost with the same personality
+        GhostStore &crowd = _simulation.GetCrowd();
+        Profiler::Scope scope(_profiler, Profiler::Phase::SpriteRender);
+        for (size_t i = 0; i < crowd.Count(); i++)
         {
-            if (_pGhosts[i] != nullptr)
+            Ghost *pLook = _simulation.GetGhost(static_cast<size_t>(crowd.GetPersonality(i)));
+            if (pLook != nullptr)
             {
-                _pGhosts[i]->Render(_pSDLRenderer);
-                RenderAITargets(i);
+                pLook->RenderAt(_pSDLRenderer, crowd.X(i), crowd.Y(i), view);
             }
         }
     }
+    _profiler.RenderOverlay(_pSDLRenderer);
+
+    Profiler::Scope scope(_profiler, Profiler::Phase::Present);
     SDL_RenderPresent(_pSDLRenderer);
 }
 
 // Small helper to factor out AI rendering for this module.  This code should not draw in a normal
 // game but might be very helpful debugging
-void GameHarness::RenderAITargets(size_t ghostIndex)
+void GameHarness::RenderAITargets(size_t ghostIndex, const SDL_Rect &view)
 {
-    Uint16 row = _pGhosts[ghostIndex]->TargetRow();
-    Uint16 col = _pGhosts[ghostIndex]->TargetCol();
+    Ghost *pGhost = _simulation.GetGhost(ghostIndex);
+    Uint16 row = pGhost->TargetRow();
+    Uint16 col = pGhost->TargetCol();
 
-    SDL_Point targetPoint = _pMaze->GetTileCoordinates(row, col);
-    targetPoint.x -= Constants::TileWidth / 2;
-    targetPoint.y -= Constants::TileHeight / 2;
+    SDL_Point targetPoint = _simulation.GetMaze()->GetTileCoordinates(row, col);
+    targetPoint.x -= (Constants::TileWidth / 2) + view.x;
+    targetPoint.y -= (Constants::TileHeight / 2) + view.y;
     SDL_Rect targetRect = { targetPoint.x, targetPoint.y, Constants::TileWidth, Constants::TileHeight };
     SDL_SetRenderDrawColor(
         _pSDLRenderer, 
-        _pGhosts[ghostIndex]->TargetColor().r, 
-        _pGhosts[ghostIndex]->TargetColor().g, 
-        _pGhosts[ghostIndex]->TargetColor().b, 
+        pGhost->TargetColor().r, 
+        pGhost->TargetColor().g, 
+        pGhost->TargetColor().b, 
         255);
     SDL_RenderFillRect(_pSDLRenderer, &targetRect);
 
@@ -355,11 +552,11 @@ void GameHarness::RenderAITargets(size_t ghostIndex)
     if (ghostIndex == 2) // Inky
     {
         //                                     Target                     Blinky
-        SDL_RenderDrawLine(_pSDLRenderer, targetPoint.x, targetPoint.y, _pGhosts[0]->X(), _pGhosts[0]->Y());
+        SDL_RenderDrawLine(_pSDLRenderer, targetPoint.x, targetPoint.y, _simulation.GetGhost(0)->X() - view.x, _simulation.GetGhost(0)->Y() - view.y);
     }
     else if (ghostIndex == 3) // Clyde
     {
-        SDL_Point clydePoint = { static_cast<int>(_pGhosts[ghostIndex]->X()), static_cast<int>(_pGhosts[ghostIndex]->Y()) };
+        SDL_Point clydePoint = { pGhost->X() - view.x, pGhost->Y() - view.y };
         SDL_Point clydeCircle[SDL_arraysize(Constants::CosineTable)] = { 0,0 };
         // Draw 'circle' using pre-calculated cos/sin table
         for (size_t j = 0; j < SDL_arraysize(Constants::CosineTable); j++)
@@ -375,14 +572,8 @@ void GameHarness::RenderAITargets(size_t ghostIndex)
 
 GameHarness::GameState GameHarness::OnLoading()
 {
+    // The sin/cos tables are generated at compile time (see constants.cpp)
     InitLevel();
-    
-    // Precalculate our sin/cos table.  This could even be hardcoded, but it won't take long
-    for (double i = 0; i < SDL_arraysize(Constants::CosineTable); i++)
-    {
-        Constants::CosineTable[static_cast<int>(i)] = SDL_cos(i/4);
-        Constants::SineTable[static_cast<int>(i)] = SDL_sin(i/4);
-    }
     return GameState::Title;
 }
 
@@ -391,17 +582,15 @@ GameHarness::GameState GameHarness::OnLoading()
 // so just delay the game a bit
 GameHarness::GameState GameHarness::OnWaitingToStartLevel()
 {
-    static StateTimer timer;
-    
-    if (!timer.IsStarted())
+    if (!_levelStartTimer.IsStarted())
     {
-        timer.Start(Constants::LevelLoadDelay);
+        _levelStartTimer.Start(Constants::LevelLoadDelay);
         InitLevel();
     }
 
-    if (timer.IsDone())
+    if (_levelStartTimer.IsDone())
     {
-        timer.Reset();
+        _levelStartTimer.Reset();
         return GameState::Running;
     }
     return GameState::WaitingToStartLevel;
@@ -411,31 +600,34 @@ GameHarness::GameState GameHarness::OnWaitingToStartLevel()
 // and their updates will need to be in here as well.  
 GameHarness::GameState GameHarness::OnRunning()
 {
-    static Uint16 pelletsEaten = 0;
     GameState stateResult = GameState::Running;
+#ifndef NDEBUG
+    // The per-tick update path should never touch the heap, keep count to make sure
+    Uint32 cAllocationsBefore = HeapAllocationCount();
+#endif
 
     // INPUT
     Direction inputDirection = Direction::None;
-    bool fQuit = ProcessInput(&inputDirection);
+    bool fQuit = false;
+    {
+        Profiler::Scope scope(_profiler, Profiler::Phase::ProcessInput);
+        fQuit = ProcessInput(&inputDirection);
+    }
     if (!fQuit)
     {
         // UPDATE
-        _pPlayer->Update(_pMaze, inputDirection); 
-        pelletsEaten += HandlePelletCollision();
-
-        // This is common, so loop through our array
-        for (size_t i = 0; i < SDL_arraysize(_pGhosts); i++)
-        {
-            if (_pGhosts[i] != nullptr)
-            {
-                _pGhosts[i]->Update(_pPlayer, _pMaze);
-            }
-        }
-        //stateResult = HandleGhostCollision();
+        Simulation::StepResult result = _simulation.Step(inputDirection);
+        //stateResult = result.fPlayerCaught ? GameState::PlayerDying : GameState::Running;
+#ifndef NDEBUG
+        _cUpdateAllocations += HeapAllocationCount() - cAllocationsBefore;
+#endif
 
-        if (pelletsEaten == Constants::TotalPellets)
+        if (result.fLevelComplete)
         {
-            pelletsEaten = 0;
+#ifndef NDEBUG
+            printf("Level complete, %u heap allocations in the update path\n", _cUpdateAllocations);
+            _cUpdateAllocations = 0;
+#endif
             return GameState::LevelComplete;
         }
     }
@@ -451,30 +643,26 @@ GameHarness::GameState GameHarness::OnRunning()
 // next level.  We only have the one level, so it just restarts
 GameHarness::GameState GameHarness::OnLevelComplete()
 {
-    static StateTimer timer;
-    static Uint16 counter = 0;
-    static bool flip;
-
-    if (!timer.IsStarted())
+    if (!_levelCompleteTimer.IsStarted())
     {
-        counter = 0;
-        flip = false;
-        timer.Start(Constants::LevelCompleteDelay);
+        _cLevelCompleteFrames = 0;
+        _fLevelCompleteFlip = false;
+        _levelCompleteTimer.Start(Constants::LevelCompleteDelay);
     }
     
-    if (counter++ > 60)
+    if (_cLevelCompleteFrames++ > 60)
     {
-        counter = 0;
-        flip = !flip;
+        _cLevelCompleteFrames = 0;
+        _fLevelCompleteFlip = !_fLevelCompleteFlip;
     }
 
-    // This will add a blue multiplier to the texture, making the shade chage.
+    // This will add a blue multiplier to the maze, making the shade chage.
     // We flip this back and forth roughly every second until the overall timer is done.
-    SDL_SetTextureColorMod(_pTilesTexture->Ptr(), 255, 255, flip ? 100 : 255);
+    _simulation.GetMaze()->SetColorMod(255, 255, _fLevelCompleteFlip ? 100 : 255);
     
-    if (timer.IsDone())
+    if (_levelCompleteTimer.IsDone())
     {
-        timer.Reset();
+        _levelCompleteTimer.Reset();
         return GameState::WaitingToStartLevel;
     }
     return GameState::LevelComplete;
@@ -482,29 +670,23 @@ GameHarness::GameState GameHarness::OnLevelComplete()
 
 void GameHarness::InitLevel()
 {
-    // This should be know, but it should also match what we just queried
-    SDL_assert(_pTilesTexture->Width() == Constants::TileTextureWidth);
-    SDL_assert(_pTilesTexture->Height() == Constants::TileTextureHeight);
-    SDL_Rect textureRect{ 0, 0, Constants::TileTextureWidth, Constants::TileTextureHeight };
-
-    SDL_SetTextureColorMod(_pTilesTexture->Ptr(), 255, 255, 255);
-
-    // Initialize our tiled map object
-    SafeDelete(_pMaze);
-    _pMaze = new Maze(Constants::MapRows, Constants::MapCols, Constants::ScreenWidth, Constants::ScreenHeight);
-
-    _pMaze->Initialize(textureRect, { 0, 0,  Constants::TileWidth,  Constants::TileHeight }, _pTilesTexture->Ptr(),
-        Constants::MapIndicies, Constants::MapRows *  Constants::MapCols);
+    // New maze and sprites back at their starting positions
+    SDL_assert(_fInitialized);
+    _simulation.InitLevel();
 
     // Clip around the maze so nothing draws there (this will help with the wrap around for example)
-    SDL_Rect mapBounds = _pMaze->GetMapBounds();
-    if (SDL_RenderSetClipRect(_pSDLRenderer, &mapBounds) != 0)
-    {
-        printf("SDL_RenderSetClipRect() failed, error = %s\n", SDL_GetError());
-    }
-    else
+    // There is no renderer to clip when headless
+    if (!_fHeadless)
     {
-        // Initialize our sprites
-        InitializeSprites();
+        SDL_Rect mapBounds = _simulation.GetMaze()->GetScreenBounds();
+        if (SDL_RenderSetClipRect(_pSDLRenderer, &mapBounds) != 0)
+        {
+            printf("SDL_RenderSetClipRect() failed, error = %s\n", SDL_GetError());
+        }
+        else
+        {
+            // Draw the static maze once up front rather than on the first frame
+            _simulation.GetMaze()->BakeCache(_pSDLRenderer);
+        }
     }
 }
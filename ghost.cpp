@@ -13,30 +13,34 @@ Ghost::Ghost(TextureWrapper *pTextureWrapper, Uint16 /*cxFrame*/, Uint16 /*cyFra
     _targetCol(0),
     _targetColor(Constants::SDLColorGrey),
     _penTimerMax(0),
+    _iSlot(0),
+    _pPartner(nullptr),
     _mode(Mode::Chase),
     _fScatter(false),
-    _pNextDecision(nullptr),
-    _pCurrentDecision(nullptr),
-    _pPrevDecision(nullptr)
+    _fTruePathing(false),
+    _iCurrentDecision(0),
+    _fNextDecision(false),
+    _fPrevDecision(false)
 {
 }
 
 // Call the subroutine based on our internal state
-void Ghost::Update(Player* pPlayer, Maze* pMaze)
+template <typename Targeting>
+void Ghost::Update(const Blackboard &blackboard, Maze* pMaze)
 {
     switch (_mode)
     {
     case Mode::ExitingPen:
-        OnExitingPen(pPlayer, pMaze);
+        OnExitingPen(blackboard, pMaze);
         break;
     case Mode::WarpingOut:
-        OnWarpingOut(pPlayer, pMaze);
+        OnWarpingOut(pMaze);
         break;
     case Mode::WarpingIn:
-        OnWarpingIn(pPlayer, pMaze);
+        OnWarpingIn(pMaze);
         break;
     case Mode::Chase:
-        OnChasing(pPlayer, pMaze);
+        OnChasing<Targeting>(blackboard, pMaze);
         break;
     }
 }
@@ -48,12 +52,12 @@ void Ghost::OnPowerPelletEaten(Maze* pMaze)
     
     if (!_scatterTimer.IsStarted())
     {
-        _scatterTimer.Start(10000);
+        _scatterTimer.Start(Constants::ScatterDuration);
     }
     else
     {
         _scatterTimer.Reset();
-        _scatterTimer.Start(10000);
+        _scatterTimer.Start(Constants::ScatterDuration);
     }
     if (_mode == Mode::Chase)
     {
@@ -64,6 +68,49 @@ void Ghost::OnPowerPelletEaten(Maze* pMaze)
     UpdateAnimation(CurrentDirection());
 }
 
+void Ghost::Save(Snapshot *pSnapshot)
+{
+    static_assert(SDL_arraysize(_decisions) == Snapshot::c_cDecisions, "Snapshot holds the whole decision ring");
+    Sprite::Save(&pSnapshot->sprite);
+    _penTimer.Save(&pSnapshot->penTimer);
+    _scatterTimer.Save(&pSnapshot->scatterTimer);
+    pSnapshot->currentRow = _currentRow;
+    pSnapshot->currentCol = _currentCol;
+    pSnapshot->targetRow = _targetRow;
+    pSnapshot->targetCol = _targetCol;
+    for (size_t i = 0; i < Snapshot::c_cDecisions; i++)
+    {
+        pSnapshot->decisionRows[i] = _decisions[i].Row();
+        pSnapshot->decisionCols[i] = _decisions[i].Col();
+        pSnapshot->decisionDirections[i] = static_cast<Uint8>(_decisions[i].GetDirection());
+    }
+    pSnapshot->iCurrentDecision = static_cast<Uint8>(_iCurrentDecision);
+    pSnapshot->mode = static_cast<Uint8>(_mode);
+    pSnapshot->fScatter = _fScatter;
+    pSnapshot->fNextDecision = _fNextDecision;
+    pSnapshot->fPrevDecision = _fPrevDecision;
+}
+
+void Ghost::Restore(const Snapshot &snapshot)
+{
+    Sprite::Restore(snapshot.sprite);
+    _penTimer.Restore(snapshot.penTimer);
+    _scatterTimer.Restore(snapshot.scatterTimer);
+    _currentRow = snapshot.currentRow;
+    _currentCol = snapshot.currentCol;
+    _targetRow = snapshot.targetRow;
+    _targetCol = snapshot.targetCol;
+    for (size_t i = 0; i < Snapshot::c_cDecisions; i++)
+    {
+        _decisions[i] = Decision(snapshot.decisionRows[i], snapshot.decisionCols[i], static_cast<Direction>(snapshot.decisionDirections[i]));
+    }
+    _iCurrentDecision = snapshot.iCurrentDecision;
+    _mode = static_cast<Mode>(snapshot.mode);
+    _fScatter = snapshot.fScatter;
+    _fNextDecision = snapshot.fNextDecision;
+    _fPrevDecision = snapshot.fPrevDecision;
+}
+
 bool Ghost::OnPlayerCollision()
 {
     return !_fScatter;
@@ -95,6 +142,16 @@ Direction Ghost::ShortestDirectionToTarget(Uint16 originRow, Uint16 originCol, U
     // we know this cell should be an intersection
     SDL_assert(pMaze->IsTileIntersection(originRow, originCol) == SDL_TRUE);
 
+    if (_fTruePathing)
+    {
+        // We'll arrive at the origin travelling in the direction of our current decision
+        result = pMaze->PathDirection(originRow, originCol, CurrentDecision().GetDirection(), targetRow, targetCol);
+        if (result != Direction::None)
+        {
+            return result;
+        }
+    }
+
     // This means there should be at least 2 options to pick from minus the
     // reverse of our current direction which is invalid
     // ...
@@ -116,7 +173,7 @@ Direction Ghost::ShortestDirectionToTarget(Uint16 originRow, Uint16 originCol, U
 
     for (size_t index = 0; index < SDL_arraysize(options); index++)
     {
-        options[index].valid = (pMaze->IsTileSolid(options[index].row, options[index].col) == SDL_FALSE);
+        options[index].valid = (pMaze->CanExit(originRow, originCol, static_cast<Direction>(index)) == SDL_TRUE);
         if (Opposite(static_cast<Direction>(index)) == CurrentDirection())
         {
             options[index].valid = false; // even though it's non solid
@@ -184,22 +241,16 @@ Direction Ghost::GetNextDirection(Uint16 r, Uint16 c, Maze *pMaze)
     };
 
     // This option is automatically invalid
-    size_t oppositeOption = static_cast<size_t>(Opposite(_pCurrentDecision->GetDirection()));
+    size_t oppositeOption = static_cast<size_t>(Opposite(CurrentDecision().GetDirection()));
     SDL_assert(oppositeOption != static_cast<size_t>(Direction::None));
 
     // Now there are 3 options left
     // Only one of them should be free
     for (size_t index = 0; index < SDL_arraysize(options); index++)
     {
-        if (index != oppositeOption)
+        if ((index != oppositeOption) && (pMaze->CanExit(r, c, options[index]) == SDL_TRUE))
         {
-            Uint16 row = r;
-            Uint16 col = c;
-            TranslateCell(row, col, options[index]);
-            if (pMaze->IsTileSolid(row, col) == SDL_FALSE)
-            {
-                return options[index];
-            }
+            return options[index];
         }
     }
 
@@ -209,17 +260,16 @@ Direction Ghost::GetNextDirection(Uint16 r, Uint16 c, Maze *pMaze)
 
 // Look ahead one tile and make a decision about what to do when we
 // eventually get there.  If the tile is an intersection, we will ask
-// our specific ghost implementation what to do.
-Ghost::Decision* Ghost::GetNextDecision(Player *pPlayer, Maze* pMaze)
+// our targeting policy where to aim for.
+template <typename Targeting>
+Ghost::Decision Ghost::GetNextDecision(const Blackboard &blackboard, Maze* pMaze)
 {
-    // Record current cell
-    SDL_Point ghostPoint = { static_cast<int>(X()), static_cast<int>(Y()) };
-    pMaze->GetTileRowCol(ghostPoint, _currentRow, _currentCol);
-
-    // Get the next cell based only on Direction of current decision
+    // Get the next cell based only on Direction of current decision.  Work from the cell the
+    // decision was made for rather than re-reading our position, right after a reversal the
+    // sprite can already be back over the line into the previous cell before it's "entered" it
     Uint16 r = _currentRow;
     Uint16 c = _currentCol;
-    TranslateCell(r, c, _pCurrentDecision->GetDirection());
+    TranslateCell(r, c, CurrentDecision().GetDirection());
 
     // This cell should be free
     SDL_assert(pMaze->IsTileSolid(r, c) == SDL_FALSE);
@@ -228,8 +278,24 @@ Ghost::Decision* Ghost::GetNextDecision(Player *pPlayer, Maze* pMaze)
     // Is the next cell an intersection?
     if (pMaze->IsTileIntersection(r, c))
     {
-        // Yes - Now we need to as the derived class
-        newDirection = MakeBranchDecision(r, c, pPlayer, pMaze);
+        // Yes - scatter home, otherwise wherever our personality says.  Off the map targets
+        // wrap around as Uint16s, which is how the original worked them out
+        if (_fScatter)
+        {
+            _targetRow = _scatterRow;
+            _targetCol = _scatterCol;
+        }
+        else
+        {
+            TargetingInput input = { _currentRow, _currentCol, _scatterRow, _scatterCol,
+                (_pPartner != nullptr) ? _pPartner->Slot() : _iSlot };
+            int targetRow = 0;
+            int targetCol = 0;
+            Targeting::Target(input, blackboard, targetRow, targetCol);
+            _targetRow = static_cast<Uint16>(targetRow);
+            _targetCol = static_cast<Uint16>(targetCol);
+        }
+        newDirection = ShortestDirectionToTarget(r, c, _targetRow, _targetCol, pMaze);
     }
     else
     {
@@ -237,53 +303,51 @@ Ghost::Decision* Ghost::GetNextDecision(Player *pPlayer, Maze* pMaze)
         newDirection = GetNextDirection(r, c, pMaze);
     }
 
-    return new Decision(r, c, newDirection);
+    return Decision(r, c, newDirection);
 }
 
 bool Ghost::IsGhostWarpingOut(Maze* pMaze)
 {
-    SDL_Point updatedPoint = { static_cast<int>(X()), static_cast<int>(Y()) };
+    SDL_Point updatedPoint = { X(), Y() };
     Uint16 row = 0;
     Uint16 col = 0;
-    pMaze->GetTileRowCol(updatedPoint, row, col);
     // Unlike the player, start warping 1 more tile inside, this is because the
     // ghost logic looks ahead one tile in normal mode and this will ensure it
     // is always in bounds of our map.  We have no need of the map indicies while
     // in "warp" mode, so just make sure we're in bounds again before changing
     // state back to Chase.
-    return ((row == Constants::WarpRow) && ((col == Constants::WarpColGhostLeft) || (col == Constants::WarpColGhostRight)));
+    return (pMaze->GetTileRowCol(updatedPoint, row, col) &&
+        (pMaze->WarpDepth(row, col) == Constants::WarpDepthGhostOut));
 }
 
-void Ghost::OnExitingPen(Player* pPlayer, Maze* pMaze)
+void Ghost::OnExitingPen(const Blackboard &blackboard, Maze* pMaze)
 {
     Sprite::Update();
     // Check if we're done exiting
     // Then change to chase mode
-    SDL_Point centerPoint = pMaze->GetTileCoordinates(14, 13);
-    if (pMaze->IsSpritePastCenter(Constants::GhostPenRowExit, Constants::GhostPenCol, this))
+    const MazeLayout::Cell &exit = pMaze->Layout().penExit;
+    SDL_Point centerPoint = pMaze->GetTileCoordinates(exit.row, exit.col);
+    if (pMaze->IsSpritePastCenter(exit.row, exit.col, this))
     {
         ResetPosition(centerPoint.x, centerPoint.y);
-        _currentRow = Constants::GhostPenRowExit;
-        _currentCol = Constants::GhostPenCol;
-        SafeDelete<Decision>(_pPrevDecision);
-        SafeDelete<Decision>(_pNextDecision);
-        SafeDelete<Decision>(_pCurrentDecision);
-
-        double speed = Constants::GhostBaseSpeed * 1.75;
-        if (pPlayer->X() < X())
+        _currentRow = exit.row;
+        _currentCol = exit.col;
+
+        Fixed speed = Constants::GhostSpeed;
+        if (blackboard.playerX < FixedX())
         {
             speed = speed * -1;
         }
 
-        SetVelocity(speed, 0.0);
-        _pCurrentDecision = new Decision(Constants::GhostPenRowExit, Constants::GhostPenCol, CurrentDirection());
+        SetVelocity(speed, 0);
+        ResetDecisions(exit.row, exit.col, CurrentDirection());
         _mode = Mode::Chase;
     }
 }
 
 // Just like the player, keep moving until out of view, but unlike the player, the 
 // ghost will incur a speed penalty while warping
-void Ghost::OnWarpingOut(Player* /*pPlayer*/, Maze* pMaze)
+void Ghost::OnWarpingOut(Maze* pMaze)
 {
     Sprite::Update();
     SDL_Rect mapRect = pMaze->GetMapBounds();
@@ -302,34 +366,32 @@ void Ghost::OnWarpingOut(Player* /*pPlayer*/, Maze* pMaze)
     }
 }
 
-void Ghost::OnWarpingIn(Player* /*pPlayer*/, Maze* pMaze)
+void Ghost::OnWarpingIn(Maze* pMaze)
 {
     // Maintain current velocity until we're back in frame
     Sprite::Update();
-    SDL_Point ghostPoint = { static_cast<int>(X()), static_cast<int>(Y()) };
+    SDL_Point ghostPoint = { X(), Y() };
     Uint16 row, col;
-    pMaze->GetTileRowCol(ghostPoint, row, col);
     // We stay in this state until we're 1 tile in from the "warp out" tile, this way
     // We won't immediately reenter the WarpingOut state and we can't turn anyway with
     // the map design, so this is an optimization
-    if ((row == Constants::WarpRow) && ((col == 2) || (col == 25)))
+    if (pMaze->GetTileRowCol(ghostPoint, row, col) &&
+        (pMaze->WarpDepth(row, col) == Constants::WarpDepthGhostIn))
     {
         // Remove the speed penalty
-        SetVelocity(2.0 * DX(), 2.0 * DY());
+        SetVelocity(2 * DX(), 2 * DY());
         _currentRow = row;
         _currentCol = col;
         // Need a new decision as well
-        SafeDelete<Decision>(_pPrevDecision);
-        SafeDelete<Decision>(_pNextDecision);
-        SafeDelete<Decision>(_pCurrentDecision);
-        _pCurrentDecision = new Decision(row, col, CurrentDirection());
+        ResetDecisions(row, col, CurrentDirection());
         _mode = Mode::Chase;
     }
 }
 
-void Ghost::OnChasing(Player* pPlayer, Maze* pMaze)
+template <typename Targeting>
+void Ghost::OnChasing(const Blackboard &blackboard, Maze* pMaze)
 {
-    if (IsGhostPenned())
+    if (IsGhostPenned(pMaze))
     {
         // Should we release it?
         if (!_penTimer.IsStarted())
@@ -339,11 +401,12 @@ void Ghost::OnChasing(Player* pPlayer, Maze* pMaze)
         }
         else if (_penTimer.IsDone())
         {
-            // Place below pen and move upward to outer row
-            SDL_Point exitPoint = pMaze->GetTileCoordinates(17, 13);
+            // Place at the bottom of the pen under the exit and move upward to outer row
+            const MazeLayout &layout = pMaze->Layout();
+            SDL_Point exitPoint = pMaze->GetTileCoordinates(layout.pen.bottom, layout.penExit.col);
             ResetPosition(exitPoint.x, exitPoint.y);
             SetAnimation(Constants::AnimationIndexUp);
-            SetVelocity(0.0, Constants::GhostBaseSpeed * -1.75);
+            SetVelocity(0, Constants::GhostSpeed * -1);
             _mode = Mode::ExitingPen;
         }
     }
@@ -363,20 +426,20 @@ void Ghost::OnChasing(Player* pPlayer, Maze* pMaze)
         SDL_Point centerPoint = pMaze->GetTileCoordinates(_currentRow, _currentCol);
         Sprite::Update();
         if (pMaze->IsSpritePastCenter(_currentRow, _currentCol, this) &&
-            _pCurrentDecision->GetDirection() != CurrentDirection())
+            CurrentDecision().GetDirection() != CurrentDirection())
         {
             ResetPosition(centerPoint.x, centerPoint.y);
             Stop();
         }
         else
         {
-            SDL_assert(_pCurrentDecision != nullptr);
-            if (_pNextDecision == nullptr)
+            if (!_fNextDecision)
             {
-                _pNextDecision = GetNextDecision(pPlayer, pMaze);
+                NextDecision() = GetNextDecision<Targeting>(blackboard, pMaze);
+                _fNextDecision = true;
             }
 
-            SDL_Point updatedPoint = { static_cast<int>(X()), static_cast<int>(Y()) };
+            SDL_Point updatedPoint = { X(), Y() };
             Uint16 row = 0;
             Uint16 col = 0;
             pMaze->GetTileRowCol(updatedPoint, row, col);
@@ -386,17 +449,13 @@ void Ghost::OnChasing(Player* pPlayer, Maze* pMaze)
                 // Entering a new cell
                 _currentRow = row;
                 _currentCol = col;
-                SDL_assert(_pNextDecision != nullptr);
-                SafeDelete<Decision>(_pPrevDecision);
-                _pPrevDecision = _pCurrentDecision;
-                _pCurrentDecision = _pNextDecision;
-                _pNextDecision = nullptr;
+                AdvanceDecisions();
 
                 // Did we move into a warp cell?
                 if (IsGhostWarpingOut(pMaze))
                 {
                     // Add a speed penalty
-                    SetVelocity(0.5 * DX(), 0.5 * DY());
+                    SetVelocity(DX() / 2, DY() / 2);
                     _mode = Mode::WarpingOut;
                 }
             }
@@ -405,7 +464,7 @@ void Ghost::OnChasing(Player* pPlayer, Maze* pMaze)
                 if (IsStopped())
                 {
                     // Set Direction
-                    UpdateAnimation(_pCurrentDecision->GetDirection());
+                    UpdateAnimation(CurrentDecision().GetDirection());
                 }
             }
         }
@@ -423,28 +482,28 @@ void Ghost::UpdateAnimation(Direction direction)
     switch (direction)
     {
     case Direction::Up:
-        SetVelocity(0, Constants::GhostBaseSpeed * -1.75);
+        SetVelocity(0, Constants::GhostSpeed * -1);
         if (!_fScatter)
         {
             SetAnimation(Constants::AnimationIndexUp);
         }
         break;
     case Direction::Down:
-        SetVelocity(0, Constants::GhostBaseSpeed * 1.75);
+        SetVelocity(0, Constants::GhostSpeed);
         if (!_fScatter)
         {
             SetAnimation(Constants::AnimationIndexDown);
         }
         break;
     case Direction::Left:
-        SetVelocity(Constants::GhostBaseSpeed * -1.75, 0);
+        SetVelocity(Constants::GhostSpeed * -1, 0);
         if (!_fScatter)
         {
             SetAnimation(Constants::AnimationIndexLeft);
         }
         break;
     case Direction::Right:
-        SetVelocity(Constants::GhostBaseSpeed * 1.75, 0);
+        SetVelocity(Constants::GhostSpeed, 0);
         if (!_fScatter)
         {
             SetAnimation(Constants::AnimationIndexRight);
@@ -457,15 +516,26 @@ void Ghost::UpdateAnimation(Direction direction)
 
 void Ghost::ReverseDirection()
 {
+    // Head back the way we came into this cell.  Right after leaving the pen or a warp there is
+    // no previous decision, but then we're still travelling in the direction we entered
+    Direction dir = Opposite(CurrentDirection());
+    if (_fPrevDecision)
+    {
+        dir = Opposite(PrevDecision().GetDirection());
+    }
+    else if (dir == Direction::None)
+    {
+        // Stopped at the center of the cell waiting to turn
+        dir = Opposite(CurrentDecision().GetDirection());
+    }
+
     // this should be safe in all cases
     SetVelocity(DX() * -1, DY() * -1);
-    SafeDelete<Decision>(_pNextDecision);
- 
-    Decision *tmp = _pCurrentDecision;
-    Direction dir = Opposite(_pPrevDecision->GetDirection());
-    _pCurrentDecision = new Decision(_currentRow, _currentCol, dir);
-
-    SafeDelete<Decision>(_pPrevDecision);
-    SafeDelete<Decision>(tmp);
+    ResetDecisions(_currentRow, _currentCol, dir);
+}
 
-}
\ No newline at end of file
+// A copy of the movement code per personality, a new policy needs its line here
+template void Ghost::Update<BlinkyTargeting>(const Blackboard &blackboard, Maze* pMaze);
+template void Ghost::Update<PinkyTargeting>(const Blackboard &blackboard, Maze* pMaze);
+template void Ghost::Update<InkyTargeting>(const Blackboard &blackboard, Maze* pMaze);
+template void Ghost::Update<ClydeTargeting>(const Blackboard &blackboard, Maze* pMaze);
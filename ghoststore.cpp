@@ -0,0 +1,331 @@
+#include "include/ghoststore.h"
+
+using namespace XplatGameTutorial::PacManClone;
+
+GhostStore::GhostStore() :
+    _cMaxGhosts(0),
+    _cGhosts(0),
+    _pClock(nullptr),
+    _msScatterEnd(0),
+    _xOrigin(0),
+    _yOrigin(0),
+    _cxMap(0),
+    _fTruePathing(false),
+    _pX(nullptr),
+    _pY(nullptr),
+    _pDX(nullptr),
+    _pDY(nullptr),
+    _pRow(nullptr),
+    _pCol(nullptr),
+    _pTargetRow(nullptr),
+    _pTargetCol(nullptr),
+    _pReleaseTime(nullptr),
+    _pMode(nullptr),
+    _pPersonality(nullptr)
+{
+}
+
+GhostStore::~GhostStore()
+{
+    delete[] _pX;
+    delete[] _pY;
+    delete[] _pDX;
+    delete[] _pDY;
+    delete[] _pRow;
+    delete[] _pCol;
+    delete[] _pTargetRow;
+    delete[] _pTargetCol;
+    delete[] _pReleaseTime;
+    delete[] _pMode;
+    delete[] _pPersonality;
+}
+
+void GhostStore::Initialize(size_t cMaxGhosts, GameClock *pClock)
+{
+    SDL_assert(_pX == nullptr);
+    _cMaxGhosts = cMaxGhosts;
+    _pClock = pClock;
+    _pX = new Fixed[cMaxGhosts];
+    _pY = new Fixed[cMaxGhosts];
+    _pDX = new Fixed[cMaxGhosts];
+    _pDY = new Fixed[cMaxGhosts];
+    _pRow = new Uint16[cMaxGhosts];
+    _pCol = new Uint16[cMaxGhosts];
+    _pTargetRow = new Uint16[cMaxGhosts];
+    _pTargetCol = new Uint16[cMaxGhosts];
+    _pReleaseTime = new Uint32[cMaxGhosts];
+    _pMode = new Uint8[cMaxGhosts];
+    _pPersonality = new Uint8[cMaxGhosts];
+}
+
+// Fill the pen a row at a time, everyone starting at the center of their tile
+void GhostStore::Reset(Maze *pMaze, size_t cGhosts)
+{
+    SDL_assert(cGhosts <= _cMaxGhosts);
+    const MazeLayout::Region &pen = pMaze->Layout().pen;
+    Uint16 cPenCols = pen.right - pen.left + 1;
+    Uint16 cPenRows = pen.bottom - pen.top + 1;
+
+    SDL_Rect mapBounds = pMaze->GetMapBounds();
+    _xOrigin = mapBounds.x;
+    _yOrigin = mapBounds.y;
+    _cxMap = ToFixed(mapBounds.w);
+    _cGhosts = cGhosts;
+    _msScatterEnd = 0;
+
+    Uint32 msNow = _pClock->Milliseconds();
+    for (size_t i = 0; i < _cGhosts; i++)
+    {
+        Uint16 row = static_cast<Uint16>(pen.top + ((i / cPenCols) % cPenRows));
+        Uint16 col = static_cast<Uint16>(pen.left + (i % cPenCols));
+        _pX[i] = TileCenter(col);
+        _pY[i] = TileCenter(row);
+        _pDX[i] = 0;
+        _pDY[i] = 0;
+        _pRow[i] = row;
+        _pCol[i] = col;
+        _pTargetRow[i] = row;
+        _pTargetCol[i] = col;
+        _pReleaseTime[i] = msNow + static_cast<Uint32>((i + 1) * c_msReleaseInterval);
+        _pMode[i] = static_cast<Uint8>(Mode::Penned);
+        _pPersonality[i] = static_cast<Uint8>(i % static_cast<size_t>(Personality::Count));
+    }
+}
+
+// The whole crowd in one pass: move, wrap through the tunnel, find the tile, and only if the
+// tile's center was reached this tick go off and decide where next
+void GhostStore::Update(const Blackboard &blackboard, Maze *pMaze)
+{
+    Uint32 msNow = _pClock->Milliseconds();
+    bool fScatter = msNow < _msScatterEnd;
+
+    for (size_t i = 0; i < _cGhosts; i++)
+    {
+        if (_pMode[i] == static_cast<Uint8>(Mode::Penned))
+        {
+            if (msNow >= _pReleaseTime[i])
+            {
+                Release(i, blackboard, pMaze);
+            }
+            continue;
+        }
+
+        Fixed dx = _pDX[i];
+        Fixed dy = _pDY[i];
+        Fixed x = _pX[i] + dx;
+        Fixed y = _pY[i] + dy;
+        Uint16 row = static_cast<Uint16>(FixedToPixels(y) / Constants::TileHeight);
+
+        // Speeds are well under half a tile, so the center was reached if it's between where we
+        // were and where we are.  That's worked out before wrapping, going off either end of a
+        // warp tunnel doesn't cross a center.  A stopped ghost (dead end) decides straight away
+        bool fOnMap = (x >= 0) && (x < _cxMap);
+        Fixed xCenter = TileCenter(fOnMap ? static_cast<Uint16>(FixedToPixels(x) / Constants::TileWidth) : 0);
+        Fixed yCenter = TileCenter(row);
+        bool fCentered =
+            (fOnMap && (dx > 0) && (x >= xCenter) && (x - dx < xCenter)) ||
+            (fOnMap && (dx < 0) && (x <= xCenter) && (x - dx > xCenter)) ||
+            ((dy > 0) && (y >= yCenter) && (y - dy < yCenter)) ||
+            ((dy < 0) && (y <= yCenter) && (y - dy > yCenter)) ||
+            ((dx == 0) && (dy == 0));
+
+        if (x < 0)
+        {
+            x += _cxMap;
+        }
+        else if (x >= _cxMap)
+        {
+            x -= _cxMap;
+        }
+        _pX[i] = x;
+        _pY[i] = y;
+        _pRow[i] = row;
+        _pCol[i] = static_cast<Uint16>(FixedToPixels(x) / Constants::TileWidth);
+
+        if (fCentered)
+        {
+            Decide(i, blackboard, pMaze, fScatter);
+        }
+    }
+}
+
+// Anywhere between two centers heading back is fine, it's where we came from or the center we
+// just decided at.  Sitting exactly on a center we've only just turned there, so the way back
+// may be a wall
+void GhostStore::OnPowerPelletEaten(Maze *pMaze)
+{
+    _msScatterEnd = _pClock->Milliseconds() + Constants::ScatterDuration;
+    for (size_t i = 0; i < _cGhosts; i++)
+    {
+        if ((_pX[i] == TileCenter(_pCol[i])) && (_pY[i] == TileCenter(_pRow[i])) &&
+            (pMaze->CanExit(_pRow[i], _pCol[i], Opposite(Heading(i))) == SDL_FALSE))
+        {
+            continue;
+        }
+        _pDX[i] = -_pDX[i];
+        _pDY[i] = -_pDY[i];
+    }
+}
+
+bool GhostStore::IsChasingOn(Uint16 row, Uint16 col)
+{
+    if (IsScattering())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < _cGhosts; i++)
+    {
+        if ((_pRow[i] == row) && (_pCol[i] == col))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Out the top of the pen, heading towards the player's side like the classic ghosts
+void GhostStore::Release(size_t i, const Blackboard &blackboard, Maze *pMaze)
+{
+    _pRow[i] = pMaze->Layout().penExit.row;
+    _pCol[i] = pMaze->Layout().penExit.col;
+    _pX[i] = TileCenter(_pCol[i]);
+    _pY[i] = TileCenter(_pRow[i]);
+    _pMode[i] = static_cast<Uint8>(Mode::Chase);
+    SetHeading(i, (blackboard.playerX < ToFixed(_xOrigin) + _pX[i]) ? Direction::Left : Direction::Right, pMaze);
+}
+
+// At a tile center: carry on along the corridor, or at an intersection take the exit closest to
+// the personality's target.  Never straight back the way we came unless it's the only way
+void GhostStore::Decide(size_t i, const Blackboard &blackboard, Maze *pMaze, bool fScatter)
+{
+    static_assert(MazeLayout::c_cGhosts == static_cast<size_t>(Personality::Count), "A scatter corner per personality");
+
+    Uint16 row = _pRow[i];
+    Uint16 col = _pCol[i];
+    Direction heading = Heading(i);
+
+    Direction direction = Direction::None;
+    if (pMaze->IsTileIntersection(row, col))
+    {
+        // Same targeting rules as the classic ghosts, whose Blinky is always in slot 0
+        const MazeLayout::Cell &scatter = pMaze->Layout().scatterTargets[_pPersonality[i]];
+        int targetRow = scatter.row;
+        int targetCol = scatter.col;
+        if (!fScatter)
+        {
+            TargetingInput input = { row, col, scatter.row, scatter.col, 0 };
+            switch (static_cast<Personality>(_pPersonality[i]))
+            {
+            case Personality::Blinky:
+                BlinkyTargeting::Target(input, blackboard, targetRow, targetCol);
+                break;
+            case Personality::Pinky:
+                PinkyTargeting::Target(input, blackboard, targetRow, targetCol);
+                break;
+            case Personality::Inky:
+                InkyTargeting::Target(input, blackboard, targetRow, targetCol);
+                break;
+            case Personality::Clyde:
+                ClydeTargeting::Target(input, blackboard, targetRow, targetCol);
+                break;
+            case Personality::Count:
+                break;
+            }
+        }
+        _pTargetRow[i] = static_cast<Uint16>(SDL_max(SDL_min(targetRow, pMaze->Rows() - 1), 0));
+        _pTargetCol[i] = static_cast<Uint16>(SDL_max(SDL_min(targetCol, pMaze->Cols() - 1), 0));
+        if (_fTruePathing)
+        {
+            direction = pMaze->PathDirection(row, col, heading, _pTargetRow[i], _pTargetCol[i]);
+        }
+
+        if (direction == Direction::None)
+        {
+            // Squared distances order the same as the real ones, ties go to the first in Direction order
+            int shortest = -1;
+            for (int option = 0; option < 4; option++)
+            {
+                Direction candidate = static_cast<Direction>(option);
+                if ((candidate != Opposite(heading)) && (pMaze->CanExit(row, col, candidate) == SDL_TRUE))
+                {
+                    Uint16 nextRow = row;
+                    Uint16 nextCol = col;
+                    pMaze->GetNextCell(row, col, nextRow, nextCol, candidate);
+                    int dr = static_cast<Sint16>(nextRow) - targetRow;
+                    int dc = static_cast<Sint16>(nextCol) - targetCol;
+                    if ((shortest < 0) || ((dr * dr) + (dc * dc) < shortest))
+                    {
+                        shortest = (dr * dr) + (dc * dc);
+                        direction = candidate;
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        for (int option = 0; (option < 4) && (direction == Direction::None); option++)
+        {
+            Direction candidate = static_cast<Direction>(option);
+            if ((candidate != Opposite(heading)) && (pMaze->CanExit(row, col, candidate) == SDL_TRUE))
+            {
+                direction = candidate;
+            }
+        }
+    }
+
+    if (direction == Direction::None)
+    {
+        // Dead end
+        direction = Opposite(heading);
+    }
+
+    if (direction != heading)
+    {
+        // Turns happen exactly on the center
+        _pX[i] = TileCenter(col);
+        _pY[i] = TileCenter(row);
+    }
+    SetHeading(i, direction, pMaze);
+}
+
+// Which way the velocity points, None when stopped
+Direction GhostStore::Heading(size_t i)
+{
+    Direction heading = Direction::None;
+    if (_pDX[i] != 0)
+    {
+        heading = (_pDX[i] > 0) ? Direction::Right : Direction::Left;
+    }
+    else if (_pDY[i] != 0)
+    {
+        heading = (_pDY[i] > 0) ? Direction::Down : Direction::Up;
+    }
+    return heading;
+}
+
+// Full speed, or half in the warp tunnel
+void GhostStore::SetHeading(size_t i, Direction direction, Maze *pMaze)
+{
+    Fixed speed = (pMaze->WarpDepth(_pRow[i], _pCol[i]) != 0) ? (Constants::GhostSpeed / 2) : Constants::GhostSpeed;
+    _pDX[i] = 0;
+    _pDY[i] = 0;
+    switch (direction)
+    {
+    case Direction::Up:
+        _pDY[i] = -speed;
+        break;
+    case Direction::Down:
+        _pDY[i] = speed;
+        break;
+    case Direction::Left:
+        _pDX[i] = -speed;
+        break;
+    case Direction::Right:
+        _pDX[i] = speed;
+        break;
+    case Direction::None:
+        break;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "constants.h"
+#include "utils.h"
+#include "assetpack.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Gets textures on screen without stalling the first frame.  Whatever is needed right away
+    // (the title) is loaded on the spot, everything else is queued up and Start() hands the PNG
+    // decoding to a worker thread.  The renderer can only be used from the main thread, so the
+    // decoded pixels are uploaded from there a slice at a time, UploadSlice() once per frame,
+    // each slice small enough not to cost a frame.
+    //
+    // Images the asset pack has are uploaded straight from it and never decoded, the PNGs are
+    // only read for anything it doesn't have.  A queued image lands in the TextureWrapper it was
+    // queued with once it's completely uploaded, until then the wrapper is a size only placeholder.
+    class AssetLoader
+    {
+    public:
+        AssetLoader();
+        ~AssetLoader();
+
+        // Use the asset pack at pszPackPath if there is one we can use
+        void Initialize(const char *pszPackPath);
+
+        // Load an image right now, null texture on failure like the PNG constructor.  The color key
+        // is only applied to PNGs, the pack has already had it applied
+        TextureWrapper* LoadNow(const char *pszImage, SDL_Color *pColorKey, SDL_Renderer *pSDLRenderer);
+
+        // Queue an image to be streamed into pTarget (not owned, has to outlive the load).  fColorKey
+        // turns Constants::SDLColorMagenta transparent.  Only before Start()
+        bool Add(const char *pszImage, bool fColorKey, TextureWrapper *pTarget);
+
+        // Kick off decoding everything queued
+        bool Start();
+
+        // Upload up to c_cbUploadSlice bytes of whatever has been decoded.  Main thread only,
+        // returns false if anything failed to load
+        bool UploadSlice(SDL_Renderer *pSDLRenderer);
+
+        bool IsLoading() { return _iUpload < _cRequests; }
+
+        // Wait for the worker and free anything not yet uploaded
+        void Cleanup();
+
+    private:
+        struct Request
+        {
+            const char *pszImage;
+            bool fColorKey;
+            TextureWrapper *pTarget;    // Not owned
+            SDL_Surface *pSurface;      // Decoded by the worker, null if it came from the pack
+            const Uint8 *pPixels;       // Into the surface or the pack
+            Uint32 format;
+            int width;
+            int height;
+            int pitch;
+            SDL_BlendMode blendMode;
+            SDL_Texture *pTexture;      // Being uploaded
+            int cRowsUploaded;
+        };
+
+        static const size_t c_maxRequests = 8;
+        static const int c_cbUploadSlice = 64 * 1024;   // Per frame
+
+        static int DecodeThread(void *pData);
+        bool InitializeImageLoader();
+
+        Request _requests[c_maxRequests];
+        size_t _cRequests;
+        size_t _iUpload;                // Next request to upload, the ones before are done
+        SDL_atomic_t _cDecoded;         // Requests [0, _cDecoded) are ready to upload
+        SDL_atomic_t _fDecodeFailed;
+        SDL_Thread *_pThread;
+        bool _fImageLoader;             // SDL_image is initialized
+        AssetPack _pack;
+    };
+}
+}
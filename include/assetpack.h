@@ -0,0 +1,81 @@
+#pragma once
+#include "utils.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Textures baked offline (--bake-assets) into one file of ready to upload pixels, so startup
+    // is a memory map and an SDL_UpdateTexture per texture with no PNG decode, no color keying
+    // and no SDL_image.  The game falls back to the PNGs if the pack is missing or stale.
+    //
+    // File layout (native byte order, so bake on the kind of machine it's going to run on):
+    //   Header
+    //   Header::cTextures Texture records
+    //   pixel data, each texture's rows starting on a c_cbAlign boundary
+    // Pixels are in c_pixelFormat with the magenta color key already turned into alpha.  Each
+    // texture's name is the image it was baked from (Constants::TilesImage etc).  The layout hash
+    // covers the frame sizes and animation tables compiled into the game, a pack baked against
+    // different ones is rejected rather than drawn with the wrong frames.
+    class AssetPack
+    {
+    public:
+        struct Header
+        {
+            char magic[4];              // "PMCA"
+            Uint32 version;
+            Uint32 layoutHash;          // LayoutHash() when baked
+            Uint32 cTextures;
+        };
+
+        struct Texture
+        {
+            char name[32];
+            Uint32 format;              // SDL_PixelFormatEnum
+            Sint32 width;
+            Sint32 height;
+            Sint32 pitch;               // Bytes per row
+            Uint32 blendMode;           // SDL_BlendMode, blended if it had alpha or a color key
+            Uint16 cxFrame;             // Grid the frames or tiles are cut from
+            Uint16 cyFrame;
+            Uint64 offset;              // Of the first row from the start of the file
+            Uint64 cbPixels;
+        };
+
+        AssetPack();
+        ~AssetPack();
+
+        // Map the pack and check it's one we can use
+        bool Open(const char *pszPath);
+        void Close();
+        bool IsOpen() { return _pData != nullptr; }
+
+        // A static texture uploaded straight from the mapped pixels, null if the pack doesn't have
+        // it or the upload fails.  The pack can be closed once the textures are created
+        TextureWrapper* CreateTexture(const char *pszName, SDL_Renderer *pSDLRenderer);
+
+        // The record for an image, null if the pack doesn't have it.  Its pixels stay valid until
+        // the pack is closed
+        const Texture* FindTexture(const char *pszName);
+        const Uint8* Pixels(const Texture &texture) { return _pData + texture.offset; }
+
+        // Decode the game's PNGs (needs SDL_image initialized) and write them out as a pack
+        static bool Bake(const char *pszPath);
+
+        // One PNG as the pack would store it, null on failure.  Caller frees the surface
+        static SDL_Surface* DecodeImage(const char *pszImage, bool fColorKey, SDL_BlendMode *pBlendMode);
+
+        // Hash of everything about the frames the pack has to agree with
+        static Uint32 LayoutHash();
+
+    private:
+        static const Uint32 c_version = 1;
+        static const Uint32 c_pixelFormat = SDL_PIXELFORMAT_ARGB8888;
+        static const size_t c_cbAlign = 64;
+
+        MappedFile _file;
+        const Uint8 *_pData;            // Whole file, read only
+        size_t _cbData;
+    };
+}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "constants.h"
+#include "utils.h"
+#include "simulation.h"
+#include "gamesnapshot.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Runs many independent games in lockstep for training agents, with no window, SDL video or
+    // frame pacing involved.  Every call to Step() advances every game by one tick with its own
+    // action and writes the results straight into the caller's buffers.  Games that finish
+    // (caught by a ghost, level cleared or out of ticks) are reset on the spot from a snapshot of
+    // the start of the level, so stepping never allocates.
+    //
+    // An observation is one byte per maze tile, row major, made up of the Observation* bits below
+    class BatchEnvironment
+    {
+    public:
+        static const Uint8 ObservationWall = 0x01;
+        static const Uint8 ObservationPellet = 0x02;
+        static const Uint8 ObservationPowerPellet = 0x04;
+        static const Uint8 ObservationPlayer = 0x08;
+        static const Uint8 ObservationGhost = 0x10;
+        static const Uint8 ObservationScaredGhost = 0x20;
+        static const size_t ObservationSize = Constants::MapRows * Constants::MapCols;
+
+        BatchEnvironment();
+        ~BatchEnvironment();
+
+        // cGames - games stepped by each call
+        // cMaxEpisodeTicks - end an episode after this many ticks (0 == only when caught or the level is cleared)
+        // fTruePathing - ghosts use the precomputed shortest paths (each game builds its own table)
+        bool Initialize(size_t cGames, Uint32 cMaxEpisodeTicks = 0, bool fTruePathing = false);
+
+        size_t GameCount() { return _cGames; }
+
+        // Start every game over, writing GameCount() * ObservationSize bytes of observations
+        void Reset(Uint8 *pObservations);
+
+        // Advance every game by one tick.  pActions[i] is a Direction for game i (None, or anything
+        // out of range, for no input).  Writes GameCount() observations (ObservationSize bytes each),
+        // rewards (points scored this tick) and done flags.  The observation of a game that just
+        // finished is already the first one of its next episode
+        void Step(const Uint8 *pActions, Uint8 *pObservations, float *pRewards, Uint8 *pDones);
+
+    private:
+        void ResetGame(size_t iGame);
+        void WriteObservation(size_t iGame, Uint8 *pObservation);
+        Uint8* TileLayer(size_t iGame) { return _pTileLayers + (iGame * ObservationSize); }
+
+        size_t _cGames;
+        Uint32 _cMaxEpisodeTicks;
+        TextureWrapper *_pTilesTexture;     // Size only placeholders, nothing is drawn
+        TextureWrapper *_pSpriteTexture;
+        Simulation *_pGames;                // One per game
+        GameClock *_pClocks;                // ...and its clock
+        Uint32 *_pEpisodeTicks;             // Ticks into the current episode per game
+        Uint8 *_pTileLayers;                // Walls and pellets left, per game, in observation form
+        Uint8 *_pStartTileLayer;            // ...as they are at the start of the level
+        GameSnapshot *_pStartSnapshot;      // Every game at the start of the level
+    };
+}
+}
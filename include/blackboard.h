@@ -0,0 +1,46 @@
+#pragma once
+#include "utils.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Everything the ghosts look at when making a decision, filled in once per tick by the
+    // GameHarness instead of each ghost working it out for itself.  Tiles that can't be
+    // resolved (e.g. the player is off the map in the warp tunnel) keep their last value.
+    struct Blackboard
+    {
+        static const size_t c_maxGhosts = 4;     // One slot per entry in GameHarness::_pGhosts
+
+        Blackboard() :
+            playerX(0),
+            playerRow(0),
+            playerCol(0),
+            playerFacing(Direction::None),
+            twoAheadRow(0),
+            twoAheadCol(0),
+            fourAheadRow(0),
+            fourAheadCol(0),
+            ghosts{ }
+        {
+        }
+
+        struct GhostInfo
+        {
+            Uint16 row;
+            Uint16 col;
+            bool fScatter;
+        };
+
+        Fixed playerX;                  // Position, for which way to leave the pen
+        Uint16 playerRow;
+        Uint16 playerCol;
+        Direction playerFacing;
+        Uint16 twoAheadRow;             // Tiles in front of the player, original up bug included
+        Uint16 twoAheadCol;
+        Uint16 fourAheadRow;
+        Uint16 fourAheadCol;
+        GhostInfo ghosts[c_maxGhosts];  // Indexed by ghost slot
+    };
+}
+}
@@ -17,7 +17,9 @@ namespace PacManClone
         // "Interface" for my ghosts to implement
         bool Initialize();
         bool Reset(Maze *pMaze);
-        Direction MakeBranchDecision(Uint16 nRow, Uint16 nCol, Player* pPlayer, Maze *pMaze);
+
+        // Straight for the player
+        void Update(const Blackboard &blackboard, Maze *pMaze) { Ghost::Update<BlinkyTargeting>(blackboard, pMaze); }
     };
 }
 }
\ No newline at end of file
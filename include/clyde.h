@@ -14,7 +14,9 @@ namespace XplatGameTutorial
             // "Interface" for my ghosts to implement
             bool Initialize();
             bool Reset(Maze *pMaze);
-            Direction MakeBranchDecision(Uint16 nRow, Uint16 nCol, Player* pPlayer, Maze *pMaze);
+
+            // The player until close, then home
+            void Update(const Blackboard &blackboard, Maze *pMaze) { Ghost::Update<ClydeTargeting>(blackboard, pMaze); }
         };
     }
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 #include "SDL.h"
+#include "fixedpoint.h"
+#include "mazelayout.h"
 
 namespace XplatGameTutorial
 {
@@ -12,6 +14,7 @@ namespace PacManClone
         static const Uint16 ScreenHeight = 600;
         static const Uint32 FramesPerSecond = 60;
         static const Uint32 TicksPerFrame;
+        static const Uint32 MaxTicksPerFrame = 5;   // Catch-up limit for the fixed timestep before ticks are dropped
         static const SDL_Color SDLColorGrey;
         static const SDL_Color SDLColorMagenta;
         static const SDL_Color RenderDrawColor;
@@ -22,10 +25,15 @@ namespace PacManClone
         static const char * const WindowTitle;
         static const Uint16 MapRows = 36;
         static const Uint16 MapCols = 28;
+        static const Uint16 MaxMazeSide = 2040;        // Most tiles across or down, the map's pixels have to fit a Fixed with room to warp
+        static const size_t MaxSnapshotTiles = 128 * 128;  // Biggest maze a GameSnapshot can hold (see PelletBoard)
         static const Uint16 TileTextureWidth = 192;
         static const Uint16 TileTextureHeight = 192;
+        static const Uint16 SpriteTextureWidth = 320;
+        static const Uint16 SpriteTextureHeight = 224;
         static const Uint16 TileWidth = 16;
         static const Uint16 TileHeight = 16;
+        static const Uint16 TileTextureCount = (TileTextureWidth / TileWidth) * (TileTextureHeight / TileHeight);   // Tile indices a maze can use
         static const Uint16 PlayerSpriteWidth = 32;
         static const Uint16 PlayerSpriteHeight = 32;
         static const Uint16 GhostSpriteWidth = 32;
@@ -33,16 +41,24 @@ namespace PacManClone
         static const Uint16 PlayerStartRow = 26;
         static const Uint16 PlayerStartCol = 13;
         static const Uint16 TotalPellets = 244;
+        static const Uint16 PelletPoints = 10;
+        static const Uint16 PowerPelletPoints = 50;
         static const Uint32 LevelLoadDelay = 3000;
         static const Uint32 LevelCompleteDelay = 6000;
+        static const Uint32 ScatterDuration = 10000;
         static const Uint16 WarpRow = 17;
-        static const Uint16 WarpColPlayerLeft = 0;
-        static const Uint16 WarpColPlayerRight = 27;
-        static const Uint16 WarpColGhostLeft = 1;
-        static const Uint16 WarpColGhostRight = 26;
+        static const Uint16 WarpTunnelDepth = 3;        // Tunnel columns tracked at each end of the warp row
+        static const Uint16 WarpDepthPlayerOut = 1;     // Tunnel depth at which each sprite starts/finishes warping
+        static const Uint16 WarpDepthPlayerIn = 2;
+        static const Uint16 WarpDepthGhostOut = 2;
+        static const Uint16 WarpDepthGhostIn = 3;
         static const Uint16 GhostPenRowExit = 14;
         static const Uint16 GhostPenRow = 17;
         static const Uint16 GhostPenCol = 13;
+        static const Uint16 GhostPenRowTop = 16;        // Inside of the pen
+        static const Uint16 GhostPenRowBottom = 17;
+        static const Uint16 GhostPenColLeft = 11;
+        static const Uint16 GhostPenColRight = 16;
         static const Uint16 BlinkyScatterRow = 0;
         static const Uint16 BlinkyScatterCol = 25;
         static const Uint16 PinkyScatterRow = 0;
@@ -52,17 +68,28 @@ namespace PacManClone
         static const Uint16 ClydeScatterRow = 35;
         static const Uint16 ClydeScatterCol = 0;
 
-        static const double PlayerMaxSpeed;
-        static const double GhostBaseSpeed;
+        // Pixels per tick (see Fixed).  Eventually speeds will be based on level, dots eaten, etc
+        static const Fixed PlayerMaxSpeed = 2 * FixedOne;
+        static const Fixed GhostBaseSpeed = (3 * FixedOne) / 4;
+        static const Fixed PlayerSpeed = (PlayerMaxSpeed * 3) / 4;      // 1.5
+        static const Fixed GhostSpeed = (GhostBaseSpeed * 7) / 4;       // 1.3125
 
         // Indices to tiles that make up the map - for your own sanity use a level editor (several free ones exist) or better
         // yet develop your own tool early in the design process
         //  We just have this one level we'll reuse, so just and paste as long as you don't change the order of the tiles.png
-        static Uint16 MapIndicies[MapRows * MapCols];
-        static Uint16 CollisionMap[MapRows * MapCols];
+        // These and the tables derived from them are generated at compile time into read-only data (see constants.cpp),
+        // anything that changes per game (eaten pellets) works on its own copy
+        static const Uint16 (&MapIndicies)[MapRows * MapCols];
+        static const Uint16 (&CollisionMap)[MapRows * MapCols];
+        static const Uint16 (&MapAttributes)[MapRows * MapCols];   // MazeAttributes of each tile in the map above
 
-        static double CosineTable[1440];
-        static double SineTable[1440];
+        // The map above with the start positions, pen, scatter corners and warp tunnel, the maze
+        // played unless another is loaded from a MazePack
+        static const MazeLayout ClassicMaze;
+
+        static const Uint16 TrigTableSize = 1440;
+        static const double (&CosineTable)[TrigTableSize];          // cos(i / 4)
+        static const double (&SineTable)[TrigTableSize];            // sin(i / 4)
 
         static const Uint16 PlayerAnimationSpeed = 5;
         static const Uint16 GhostAnimationSpeed = 8;
@@ -85,31 +112,33 @@ namespace PacManClone
         static const Uint16 PlayerTotalAnimationCount = 5;
         static const Uint16 PlayerAnimationFrameCount = 4;
         static const Uint16 PlayerAnimationDeathFrameCount = 11;
-        static int PlayerAnimation_UP[PlayerAnimationFrameCount];
-        static int PlayerAnimation_DOWN[PlayerAnimationFrameCount];
-        static int PlayerAnimation_LEFT[PlayerAnimationFrameCount];
-        static int PlayerAnimation_RIGHT[PlayerAnimationFrameCount];
-        static int PlayerAnimation_DEATH[PlayerAnimationDeathFrameCount];
+        static const int PlayerAnimation_UP[PlayerAnimationFrameCount];
+        static const int PlayerAnimation_DOWN[PlayerAnimationFrameCount];
+        static const int PlayerAnimation_LEFT[PlayerAnimationFrameCount];
+        static const int PlayerAnimation_RIGHT[PlayerAnimationFrameCount];
+        static const int PlayerAnimation_DEATH[PlayerAnimationDeathFrameCount];
 
         static const Uint16 GhostTotalFrameCount = 16;
         static const Uint16 GhostTotalAnimationCount = 10;
         static const Uint16 GhostMovingAnimationFrameCount = 2;
         static const Uint16 GhostScaredAnimationFrameCount = 4;
-        static int GhostAnimation_UP[GhostMovingAnimationFrameCount];
-        static int GhostAnimation_DOWN[GhostMovingAnimationFrameCount];
-        static int GhostAnimation_LEFT[GhostMovingAnimationFrameCount];
-        static int GhostAnimation_RIGHT[GhostMovingAnimationFrameCount];
-        static int GhostAnimation_FRIGHT[GhostMovingAnimationFrameCount];
-        static int GhostAnimation_SCARED[GhostScaredAnimationFrameCount];
-        static int GhostAnimation_DEATHUP[GhostMovingAnimationFrameCount];
-        static int GhostAnimation_DEATHDOWN[GhostMovingAnimationFrameCount];
-        static int GhostAnimation_DEATHLEFT[GhostMovingAnimationFrameCount];
-        static int GhostAnimation_DEATHRIGHT[GhostMovingAnimationFrameCount];
+        static const int GhostAnimation_UP[GhostMovingAnimationFrameCount];
+        static const int GhostAnimation_DOWN[GhostMovingAnimationFrameCount];
+        static const int GhostAnimation_LEFT[GhostMovingAnimationFrameCount];
+        static const int GhostAnimation_RIGHT[GhostMovingAnimationFrameCount];
+        static const int GhostAnimation_FRIGHT[GhostMovingAnimationFrameCount];
+        static const int GhostAnimation_SCARED[GhostScaredAnimationFrameCount];
+        static const int GhostAnimation_DEATHUP[GhostMovingAnimationFrameCount];
+        static const int GhostAnimation_DEATHDOWN[GhostMovingAnimationFrameCount];
+        static const int GhostAnimation_DEATHLEFT[GhostMovingAnimationFrameCount];
+        static const int GhostAnimation_DEATHRIGHT[GhostMovingAnimationFrameCount];
 
         // Strings
         static const char * const TilesImage;
         static const char * const SpritesImage;
         static const char * const TitleImage;
+        static const char * const AssetPackFile;
+        static const char * const ProfileCsvFile;
 
     private:
         static const Uint32 c_msPerSecond = 1000;
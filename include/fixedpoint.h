@@ -0,0 +1,26 @@
+#pragma once
+#include "SDL.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Sprite positions and velocities are 16.16 fixed point: whole pixels in the top 16 bits and
+    // 1/65536ths of a pixel below.  Every speed in the game is exact in it, and integer adds come
+    // out the same whatever the compiler or optimization level, so a replay recorded on one build
+    // checks out on any other
+    typedef Sint32 Fixed;
+
+    static const int FixedShift = 16;
+    static const Fixed FixedOne = 1 << FixedShift;
+
+    // Whole pixels to fixed
+    inline constexpr Fixed ToFixed(int pixels) { return static_cast<Fixed>(pixels * FixedOne); }
+
+    // Fixed to whole pixels, rounding down.  Positions do go negative (a sprite warping out is
+    // left of the map, and a map bigger than the screen starts at 0), where >> still floors: it's
+    // an arithmetic shift on every compiler we build with, checked below rather than assumed
+    inline constexpr int FixedToPixels(Fixed value) { return value >> FixedShift; }
+    static_assert(FixedToPixels(-1) == -1, "FixedToPixels needs >> to be an arithmetic shift");
+}
+}
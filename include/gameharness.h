@@ -2,11 +2,12 @@
 #include <stdio.h>
 #include "constants.h"
 #include "utils.h"
-#include "player.h"
-#include "blinky.h"
-#include "pinky.h"
-#include "inky.h"
-#include "clyde.h"
+#include "simulation.h"
+#include "profiler.h"
+#include "inputreplay.h"
+#include "gamesnapshot.h"
+#include "assetloader.h"
+#include "mazepack.h"
 
 namespace XplatGameTutorial
 {
@@ -21,28 +22,70 @@ class GameHarness
 public:
     GameHarness() :
         _fInitialized(false),
+        _fHeadless(false),
+        _cMaxFrames(0),
+        _cUpdateAllocations(0),
+        _fReplayFailed(false),
+        _fVerifyMaze(false),
         _state(GameState::LoadingResources),
+        _cLevelCompleteFrames(0),
+        _fLevelCompleteFlip(false),
         _pSDLRenderer(nullptr),
         _pSDLWindow(nullptr),
         _pTilesTexture(nullptr),
         _pSpriteTexture(nullptr),
-        _pMaze(nullptr),
-        _pPlayer(nullptr),
-        _pBlinky(nullptr),
-        _pPinky(nullptr),
-        _pInky(nullptr),
-        _pClyde(nullptr)
+        _pTitleTexture(nullptr)
     {
-        for (size_t i = 0; i < SDL_arraysize(_pGhosts); i++)
-        {
-            _pGhosts[i] = nullptr;
-        }
+        SDL_memset(&_options, 0, sizeof(_options));
+        _simulation.SetProfiler(&_profiler);
+        _levelStartTimer.SetClock(&_clock);
+        _levelCompleteTimer.SetClock(&_clock);
     }
 
-    SDL_bool Initialize();  // Needs to be called successfully before Run()
+    // Needs to be called successfully before Run().  Headless skips the window, renderer and
+    // textures entirely and runs the simulation uncapped, optionally stopping after cMaxFrames ticks
+    SDL_bool Initialize(bool fHeadless = false, Uint32 cMaxFrames = 0);
     void Run();             // Main loop
 
+    // Ghosts follow precomputed shortest paths instead of the original greedy targeting
+    void EnableTruePathing(bool fEnable)
+    {
+        _options.fTruePathing = fEnable;
+        _simulation.SetTruePathing(fEnable);
+    }
+
+    // Party mode, this many extra ghosts on top of the classic four
+    void EnableCrowd(Uint32 cGhosts)
+    {
+        _options.cCrowdGhosts = cGhosts;
+        _simulation.SetCrowdGhosts(cGhosts);
+    }
+
+    // Play maze iMaze of a MazePack instead of the classic maze.  The pack stays mapped for as
+    // long as we're around
+    bool LoadMaze(const char *pszPath, Uint32 iMaze);
+    // Check every tile of the maze as it's loaded rather than trusting the pack (slow on big mazes)
+    void EnableMazeVerification(bool fEnable) { _fVerifyMaze = fEnable; }
+
+    // Time the phases of each frame from the start (F1 toggles the overlay, which also turns this on)
+    void EnableProfiling(bool fEnable) { _profiler.Enable(fEnable); }
+
+    // Record the input of this game to a file, or play one back instead of reading the keyboard.
+    // Call after Initialize.  Playback runs in real time, or as fast as possible when headless, and
+    // plays with the options the recording was made with (true pathing, crowd, maze)
+    bool RecordReplay(const char *pszPath) { return _replay.StartRecording(pszPath, _fHeadless, _options); }
+    bool PlayReplay(const char *pszPath);
+    // The replay we played couldn't be started or didn't end up in the same state as when it was recorded
+    bool ReplayFailed() { return _fReplayFailed; }
+
+    // Capture everything that changes during play, or put it all back.  Needs the maze and
+    // sprites, so only once loading is done
+    void SaveSnapshot(GameSnapshot *pSnapshot);
+    void RestoreSnapshot(const GameSnapshot &snapshot);
+
 private:
+    friend class Benchmark;     // bench/bench.cpp steps the running state directly
+
     enum class GameState
     {
         LoadingResources,       // Load resources (textures etc) from disk
@@ -57,12 +100,12 @@ private:
 
     // Methods
     void Cleanup();
-    void InitializeSprites();
+    bool UpdateState();
     bool ProcessInput(Direction *pInputDirection);
-    Uint16 HandlePelletCollision();
-    GameState HandleGhostCollision();
+    bool ReadKeyboard(Direction *pInputDirection);
+    Uint64 StateChecksum();
     void Render();
-    void RenderAITargets(size_t ghostIndex);
+    void RenderAITargets(size_t ghostIndex, const SDL_Rect &view);
     void InitLevel();
     
     
@@ -74,19 +117,29 @@ private:
     
     // Members
     bool _fInitialized;                 // Tracks if we've started SDL
+    bool _fHeadless;                    // No window, renderer, textures or frame pacing
+    Uint32 _cMaxFrames;                 // Simulation ticks to run before exiting (0 == until quit)
+    Uint32 _cUpdateAllocations;         // Heap allocations made by OnRunning this level (debug builds)
+    bool _fReplayFailed;                // Playback didn't match the recording
+    bool _fVerifyMaze;                  // LoadMaze checks the pack's layers too
     GameState _state;                   // current GameState
+    Uint16 _cLevelCompleteFrames;       // Frames since the level complete flash last flipped
+    bool _fLevelCompleteFlip;           // Level complete flash is showing the tinted maze
+    GameClock _clock;                   // Simulation time, advanced once per UpdateState()
+    StateTimer _levelStartTimer;        // Delay before a level starts
+    StateTimer _levelCompleteTimer;     // Flashing maze after the last pellet
     SDL_Renderer *_pSDLRenderer;        // SDL renderer object
     SDL_Window *_pSDLWindow;            // SDL window object
     TextureWrapper *_pTilesTexture;     // Texture that holds the maze tiles
     TextureWrapper *_pSpriteTexture;    // Texture that holds the sprite frames
     TextureWrapper *_pTitleTexture;     // Texture that holds the title screen
-    Maze *_pMaze;                       // Maze - playing area
-    Player *_pPlayer;                   // The player sprite PacManClone
-    Blinky *_pBlinky;                   // Blinky
-    Pinky  *_pPinky;                    // Pinky
-    Inky  *_pInky;                      // Inky
-    Clyde *_pClyde;                     // Clyde
-    Ghost* _pGhosts[4];                 // Stick our ghosts in here for easy access to common code
+    AssetLoader _loader;                // Streams the tiles and sprites in behind the title
+    MazePack _mazePack;                 // Where the maze came from if it isn't the classic one
+    MazeLayout _mazeLayout;             // ...and the maze, pointing into the pack
+    Simulation _simulation;             // The maze, player and ghosts
+    Profiler _profiler;                 // Frame phase timings
+    InputReplay _replay;                // Input recording/playback
+    InputReplay::Options _options;      // What we were asked to play, for the recording
 };
 }
 }
\ No newline at end of file
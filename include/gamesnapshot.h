@@ -0,0 +1,36 @@
+#pragma once
+#include <type_traits>
+#include "constants.h"
+#include "utils.h"
+#include "player.h"
+#include "ghost.h"
+#include "blackboard.h"
+#include "pelletboard.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Everything that changes while the game plays, in one flat block.  It's trivially copyable,
+    // so a snapshot can be kept, copied or written out with a plain memcpy (rewinding, search
+    // based bots, dumping the state when something goes wrong).  GameHarness::SaveSnapshot and
+    // RestoreSnapshot fill it in and put it back; textures, frames and animation sequences never
+    // change once loaded so they stay with their objects.
+    struct GameSnapshot
+    {
+        Uint8 state;                                // GameHarness::GameState
+        Uint32 clockTicks;
+        StateTimer::Snapshot levelStartTimer;
+        StateTimer::Snapshot levelCompleteTimer;
+        Uint16 cLevelCompleteFrames;
+        bool fLevelCompleteFlip;
+        Blackboard blackboard;                      // Keeps last known tiles between ticks
+        Player::Snapshot player;
+        Ghost::Snapshot ghosts[Blackboard::c_maxGhosts];
+        PelletBoard pellets;                        // Pellets left to eat
+        PelletBoard powerPellets;
+    };
+
+    static_assert(std::is_trivially_copyable<GameSnapshot>::value, "GameSnapshot has to stay memcpy-able");
+}
+}
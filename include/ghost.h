@@ -2,15 +2,18 @@
 #include "sprite.h"
 #include "maze.h"
 #include "player.h"
+#include "blackboard.h"
+#include "ghosttargeting.h"
 
 namespace XplatGameTutorial
 {
 namespace PacManClone
 {
     // Our Ghost class will encapsulate the basic behavior common to every ghost
-    // (e.g. movement when not at an intersection) but will defer branching logic
-    // (e.g. the case above - intersections) and texture specific loading and values
-    // like base speed to a derived class.
+    // (e.g. movement when not at an intersection) and defer texture specific loading
+    // and values like start position to a derived class.  Where to aim for at an
+    // intersection is a targeting policy (see ghosttargeting.h) the derived class
+    // picks when it calls Update.
     // I.e. this class does not exist by itself, somewhere there is a Blinky : Ghost,
     // Clyde : Ghost, etc
     class Ghost : public Sprite
@@ -20,28 +23,78 @@ namespace PacManClone
 
         virtual ~Ghost()
         {
-            SafeDelete<Decision>(_pPrevDecision);
-            SafeDelete<Decision>(_pCurrentDecision);
-            SafeDelete<Decision>(_pNextDecision);
         }
 
         // "Interface" for Ghosts to implement
         virtual bool Initialize() = 0;
         virtual bool Reset(Maze *pMaze) = 0;
-        virtual Direction MakeBranchDecision(Uint16 nRow, Uint16 nCol, Player* pPlayer, Maze *pMaze) = 0;
 
-        // General movement that is common to all ghosts
-        void Update(Player* pPlayer, Maze* pMaze);
+        // General movement that is common to all ghosts, with Targeting's rule decided at
+        // intersections.  Instantiated in ghost.cpp for each of the policies
+        template <typename Targeting> void Update(const Blackboard &blackboard, Maze* pMaze);
         void OnPowerPelletEaten(Maze* pMaze);
         bool OnPlayerCollision();
 
+        // Pen and scatter timers run on game time
+        void SetClock(GameClock *pClock)
+        {
+            _penTimer.SetClock(pClock);
+            _scatterTimer.SetClock(pClock);
+        }
+
+        // Decide at intersections with the maze's precomputed shortest paths instead of the
+        // straight line distance heuristic (needs Maze::BuildPathTable)
+        void SetTruePathing(bool fTruePathing) { _fTruePathing = fTruePathing; }
+
+        // Which Blackboard::ghosts entry describes this ghost
+        void SetSlot(size_t iSlot) { SDL_assert(iSlot < Blackboard::c_maxGhosts); _iSlot = iSlot; }
+        size_t Slot() { return _iSlot; }
+
+        // Another ghost whose position our targeting works off (Inky's Blinky), not owned
+        void SetPartner(Ghost *pPartner) { _pPartner = pPartner; }
+
+        bool IsScattering() { return _fScatter; }
+
         Uint16 TargetRow() { return _targetRow; }
         Uint16 TargetCol() { return _targetCol; }
         SDL_Color TargetColor() { return _targetColor; }
 
+        // The ghost's movement and AI state.  Scatter targets, pen delays and colors are fixed
+        // per ghost so they aren't included
+        struct Snapshot
+        {
+            static const size_t c_cDecisions = 3;
+
+            Sprite::Snapshot sprite;
+            StateTimer::Snapshot penTimer;
+            StateTimer::Snapshot scatterTimer;
+            Uint16 currentRow;
+            Uint16 currentCol;
+            Uint16 targetRow;
+            Uint16 targetCol;
+            Uint16 decisionRows[c_cDecisions];
+            Uint16 decisionCols[c_cDecisions];
+            Uint8 decisionDirections[c_cDecisions];
+            Uint8 iCurrentDecision;
+            Uint8 mode;
+            bool fScatter;
+            bool fNextDecision;
+            bool fPrevDecision;
+        };
+
+        void Save(Snapshot *pSnapshot);
+        void Restore(const Snapshot &snapshot);
+
     protected:
         struct Decision
         {
+            Decision() :
+                row(0),
+                col(0),
+                direction(Direction::None)
+            {
+            }
+
             Decision(Uint16 r, Uint16 c, Direction newDirection) :
                 row(r),
                 col(c),
@@ -71,24 +124,47 @@ namespace PacManClone
         void InitializeCommon();
         Direction ShortestDirectionToTarget(Uint16 originRow, Uint16 originCol, Uint16 targetRow, Uint16 targetCol, Maze *pMaze);
         Direction GetNextDirection(Uint16 r, Uint16 c, Maze *pMaze);
-        Decision* GetNextDecision(Player *pPlayer, Maze* pMaze);
+        template <typename Targeting> Decision GetNextDecision(const Blackboard &blackboard, Maze* pMaze);
         bool IsGhostWarpingOut(Maze* pMaze);
-        bool IsGhostPenned()
+        bool IsGhostPenned(Maze* pMaze)
         {
-            return (_currentCol > 10 && _currentCol < 17 && _currentRow > 15 && _currentRow < 18);
+            return (pMaze->IsTilePen(_currentRow, _currentCol) == SDL_TRUE);
         }
         
-        void Stop() { SetVelocity(0.0, 0.0); }
-        bool IsStopped() { return (DX() == 0.0 && DY() == 0.0); }
+        void Stop() { SetVelocity(0, 0); }
+        bool IsStopped() { return (DX() == 0 && DY() == 0); }
         void SetPenTimerMax(Uint32 max) { _penTimerMax = max; }
-        void OnExitingPen(Player* pPlayer, Maze* pMaze);
-        void OnWarpingOut(Player* pPlayer, Maze* pMaze);
-        void OnWarpingIn(Player* pPlayer, Maze* pMaze);
-        void OnChasing(Player* pPlayer, Maze* pMaze);
+        void OnExitingPen(const Blackboard &blackboard, Maze* pMaze);
+        void OnWarpingOut(Maze* pMaze);
+        void OnWarpingIn(Maze* pMaze);
+        template <typename Targeting> void OnChasing(const Blackboard &blackboard, Maze* pMaze);
 
         void UpdateAnimation(Direction direction);
         void ReverseDirection();
 
+        // The previous, current and next decisions live by value in a 3 slot ring, so moving
+        // to a new cell just rotates the ring instead of allocating
+        Decision& PrevDecision() { return _decisions[(_iCurrentDecision + 2) % SDL_arraysize(_decisions)]; }
+        Decision& CurrentDecision() { return _decisions[_iCurrentDecision]; }
+        Decision& NextDecision() { return _decisions[(_iCurrentDecision + 1) % SDL_arraysize(_decisions)]; }
+
+        // Start over from a single known decision (level start, leaving the pen or a warp)
+        void ResetDecisions(Uint16 row, Uint16 col, Direction direction)
+        {
+            CurrentDecision() = Decision(row, col, direction);
+            _fPrevDecision = false;
+            _fNextDecision = false;
+        }
+
+        // Entering a new cell, the next decision becomes the current one
+        void AdvanceDecisions()
+        {
+            SDL_assert(_fNextDecision);
+            _iCurrentDecision = (_iCurrentDecision + 1) % SDL_arraysize(_decisions);
+            _fPrevDecision = true;
+            _fNextDecision = false;
+        }
+
         StateTimer _penTimer;           // Timer used to exit initial pen area
         StateTimer _scatterTimer;       // Timer used to exit scatter
         Uint16 _currentRow;             // Current cell location
@@ -99,11 +175,15 @@ namespace PacManClone
         Uint16 _targetCol;
         SDL_Color _targetColor;
         Uint32 _penTimerMax;
+        size_t _iSlot;                  // Our entry in the blackboard
+        Ghost *_pPartner;               // Not owned, null if the targeting doesn't need one
         Mode _mode;                     // Chase, scatter, etc
         bool _fScatter;                 // Scattering
-        Decision *_pNextDecision;       // Decision for the coming cell
-        Decision *_pCurrentDecision;    // Decision for our current cell
-        Decision *_pPrevDecision;       // Decision last cell (for reversing easily)
+        bool _fTruePathing;             // Use the maze path table rather than the distance heuristic
+        Decision _decisions[3];         // Ring of decisions for the last, current and coming cells
+        Uint16 _iCurrentDecision;       // Slot in the ring holding the decision for our current cell
+        bool _fNextDecision;            // Decision for the coming cell has been made
+        bool _fPrevDecision;            // Decision for the last cell is known (for reversing easily)
     };
 }
 }
\ No newline at end of file
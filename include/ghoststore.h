@@ -0,0 +1,109 @@
+#pragma once
+#include "constants.h"
+#include "utils.h"
+#include "maze.h"
+#include "blackboard.h"
+#include "ghosttargeting.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Lots of ghosts (stress testing, party mode) kept as a structure of arrays.  Each field the
+    // per tick update touches is its own contiguous array and every ghost is updated in one pass,
+    // so the cost is linear in the number of ghosts and there's no heap object, virtual call or
+    // animation state per ghost.
+    //
+    // They follow the classic ghosts' rules - the four targeting personalities, no reversing,
+    // turns only at tile centers, slowed down in the warp tunnel, scattering when a power pellet
+    // is eaten - but decide on reaching a tile rather than one tile ahead, and leave the pen by
+    // being placed on its exit once their release time comes.  Positions are 16.16 fixed point
+    // relative to the map's top left corner.
+    class GhostStore
+    {
+    public:
+        // Whose targeting a ghost uses, same order as the classic ghosts' slots
+        enum class Personality : Uint8
+        {
+            Blinky = 0,
+            Pinky,
+            Inky,
+            Clyde,
+            Count
+        };
+
+        GhostStore();
+        ~GhostStore();
+
+        // Everything is allocated here for up to cMaxGhosts, nothing after.  Release and scatter
+        // times run on the clock (not owned)
+        void Initialize(size_t cMaxGhosts, GameClock *pClock);
+
+        // cGhosts in the pen with the personalities taking turns, let out one after another
+        void Reset(Maze *pMaze, size_t cGhosts);
+
+        // Move every ghost one tick and decide at any tile centers reached
+        void Update(const Blackboard &blackboard, Maze *pMaze);
+
+        // Chase along the maze's shortest paths rather than the straight line heuristic (needs
+        // Maze::BuildPathTable).  Ghosts after the same tile share the maze's searches
+        void SetTruePathing(bool fTruePathing) { _fTruePathing = fTruePathing; }
+
+        // Scatter for Constants::ScatterDuration, turning around if out of the pen
+        void OnPowerPelletEaten(Maze *pMaze);
+
+        // A ghost that isn't scattering is on this tile
+        bool IsChasingOn(Uint16 row, Uint16 col);
+
+        size_t Capacity() { return _cMaxGhosts; }
+        size_t Count() { return _cGhosts; }
+        bool IsScattering() { return _pClock->Milliseconds() < _msScatterEnd; }
+
+        // Screen position of a ghost in pixels
+        int X(size_t i) { return _xOrigin + FixedToPixels(_pX[i]); }
+        int Y(size_t i) { return _yOrigin + FixedToPixels(_pY[i]); }
+        Uint16 Row(size_t i) { return _pRow[i]; }
+        Uint16 Col(size_t i) { return _pCol[i]; }
+        Uint16 TargetRow(size_t i) { return _pTargetRow[i]; }
+        Uint16 TargetCol(size_t i) { return _pTargetCol[i]; }
+        Personality GetPersonality(size_t i) { return static_cast<Personality>(_pPersonality[i]); }
+
+    private:
+        enum class Mode : Uint8
+        {
+            Penned = 0,
+            Chase
+        };
+
+        static const Uint32 c_msReleaseInterval = 250;  // Between one ghost leaving the pen and the next
+
+        void Release(size_t i, const Blackboard &blackboard, Maze *pMaze);
+        void Decide(size_t i, const Blackboard &blackboard, Maze *pMaze, bool fScatter);
+        Direction Heading(size_t i);
+        void SetHeading(size_t i, Direction direction, Maze *pMaze);
+        Fixed TileCenter(Uint16 tile) { return ToFixed((tile * Constants::TileWidth) + (Constants::TileWidth / 2)); }
+
+        size_t _cMaxGhosts;
+        size_t _cGhosts;
+        GameClock *_pClock;             // Game time (not owned)
+        Uint32 _msScatterEnd;           // Everyone scatters together
+        int _xOrigin;                   // Map's top left corner on the screen
+        int _yOrigin;
+        Fixed _cxMap;                   // Map width, for wrapping through the warp tunnel
+        bool _fTruePathing;             // Use the maze's paths rather than the distance heuristic
+
+        // One entry per ghost in each
+        Fixed *_pX;
+        Fixed *_pY;
+        Fixed *_pDX;
+        Fixed *_pDY;
+        Uint16 *_pRow;                  // Tile the ghost is on
+        Uint16 *_pCol;
+        Uint16 *_pTargetRow;            // Where it was headed at its last decision
+        Uint16 *_pTargetCol;
+        Uint32 *_pReleaseTime;          // Game time (ms) it leaves the pen
+        Uint8 *_pMode;                  // Mode
+        Uint8 *_pPersonality;           // Personality
+    };
+}
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "utils.h"
+#include "blackboard.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // What a targeting rule gets to look at besides the blackboard
+    struct TargetingInput
+    {
+        Uint16 row;                     // Tile the ghost is on
+        Uint16 col;
+        Uint16 scatterRow;              // Its home corner
+        Uint16 scatterCol;
+        size_t iPartnerSlot;            // Blackboard slot of the ghost it works with (Inky's Blinky)
+    };
+
+    // The ghosts' personalities are just where they aim for when chasing, and each one is a policy
+    // type with a single static Target().  Ghost::Update is a template on the policy so every ghost
+    // type gets its own copy of the movement code with the targeting inlined into it, and a new
+    // personality is another struct here rather than another Ghost subclass.  Targets are ints,
+    // they can land off the map (Inky) and it's up to the caller what to do with that.
+    //
+    // Scattering is the same for everyone and is handled by the caller, these are only asked while
+    // chasing
+
+    // Blinky goes straight for the player's tile.  We won't bother with "Elroy" states at the moment
+    struct BlinkyTargeting
+    {
+        static void Target(const TargetingInput & /*input*/, const Blackboard &blackboard, int &targetRow, int &targetCol)
+        {
+            targetRow = blackboard.playerRow;
+            targetCol = blackboard.playerCol;
+        }
+    };
+
+    // Pinky aims 4 tiles ahead of the player
+    struct PinkyTargeting
+    {
+        static void Target(const TargetingInput & /*input*/, const Blackboard &blackboard, int &targetRow, int &targetCol)
+        {
+            targetRow = blackboard.fourAheadRow;
+            targetCol = blackboard.fourAheadCol;
+        }
+    };
+
+    // Inky extends the line from Blinky to 2 tiles ahead of the player by the same again
+    struct InkyTargeting
+    {
+        static void Target(const TargetingInput &input, const Blackboard &blackboard, int &targetRow, int &targetCol)
+        {
+            const Blackboard::GhostInfo &partner = blackboard.ghosts[input.iPartnerSlot];
+            targetRow = (2 * blackboard.twoAheadRow) - partner.row;
+            targetCol = (2 * blackboard.twoAheadCol) - partner.col;
+        }
+    };
+
+    // Clyde chases the player until he's within 8 tiles, then heads home to his corner
+    struct ClydeTargeting
+    {
+        static void Target(const TargetingInput &input, const Blackboard &blackboard, int &targetRow, int &targetCol)
+        {
+            if (Distance(input.row, input.col, blackboard.playerRow, blackboard.playerCol) < 8)
+            {
+                targetRow = input.scatterRow;
+                targetCol = input.scatterCol;
+            }
+            else
+            {
+                targetRow = blackboard.playerRow;
+                targetCol = blackboard.playerCol;
+            }
+        }
+    };
+}
+}
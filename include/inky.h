@@ -14,14 +14,9 @@ namespace XplatGameTutorial
             // "Interface" for my ghosts to implement
             bool Initialize();
             bool Reset(Maze *pMaze);
-            Direction MakeBranchDecision(Uint16 nRow, Uint16 nCol, Player* pPlayer, Maze *pMaze);
 
-            void SetBlinkyReference(Ghost* pBlinkyGhost) { _pBlinky = pBlinkyGhost; }
-            Ghost* GetBlinkyReference() { return _pBlinky; }
-
-
-        private:
-            Ghost *_pBlinky; // Not owned
+            // Off Blinky and 2 tiles ahead of the player
+            void Update(const Blackboard &blackboard, Maze *pMaze) { Ghost::Update<InkyTargeting>(blackboard, pMaze); }
         };
     }
 }
\ No newline at end of file
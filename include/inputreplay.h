@@ -0,0 +1,95 @@
+#pragma once
+#include "utils.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Records the input the game sees each time it asks for it and plays it back exactly.  The
+    // simulation only runs on GameClock ticks, so the same inputs always produce the same game.
+    //
+    // File layout (all little endian):
+    //   "PMCR", version (1 byte), flags (1 byte)
+    //   crowd ghosts (4 bytes), maze index (4 bytes), maze pack path length (2 bytes) and path
+    //   runs of: input (1 byte, Direction in the low bits plus c_inputQuit), count (LEB128 varint)
+    //   c_endOfInput (1 byte), total ticks (4 bytes), state checksum (8 bytes)
+    // The trailer lets playback stop on the same tick the recording did and check it ended up in
+    // the same state.  The options that change how the game plays are kept in the header so
+    // playback can put them back.
+    class InputReplay
+    {
+    public:
+        static const size_t c_cchMazePathMax = 256;
+
+        // Everything from the command line the simulation depends on
+        struct Options
+        {
+            bool fTruePathing;
+            Uint32 cCrowdGhosts;
+            Uint32 iMaze;
+            char szMazePath[c_cchMazePathMax];      // Maze pack, empty for the classic maze
+        };
+
+        InputReplay();
+        ~InputReplay();
+
+        // fAutoStart - the title screen advances on its own (headless) rather than waiting for input
+        bool StartRecording(const char *pszPath, bool fAutoStart, const Options &options);
+        void StopRecording(Uint64 checksum);
+        bool StartPlayback(const char *pszPath);
+        // Playback: what the recording was made with
+        const Options& RecordedOptions() { return _options; }
+
+        bool IsRecording() { return _pFile != nullptr; }
+        bool IsPlaying() { return _pData != nullptr; }
+        bool AutoStart() { return _fAutoStart; }
+
+        // Call once per simulation tick
+        void Tick() { _cTicks++; }
+        // Playback has reached the tick the recording stopped on
+        bool IsPlaybackDone() { return IsPlaying() && (_cTicks >= _cTicksTotal); }
+        // Report whether we ended up where the recording did, and stop
+        bool FinishPlayback(Uint64 checksum);
+        // Stop without checking anything
+        void StopPlayback();
+
+        // Recording: remember what ProcessInput came up with
+        void WriteInput(Direction direction, bool fQuit);
+        // Playback: the next recorded input.  Returns the quit flag, and also quits if the
+        // recording has run out early
+        bool ReadInput(Direction *pDirection);
+
+    private:
+        static const Uint8 c_version = 3;              // 2: the checksum hashes fixed point positions, 3: options
+        static const Uint8 c_flagAutoStart = 0x01;
+        static const Uint8 c_flagTruePathing = 0x02;
+        static const Uint8 c_inputDirectionMask = 0x07;
+        static const Uint8 c_inputQuit = 0x08;
+        static const Uint8 c_endOfInput = 0xFF;
+        static const size_t c_cbHeader = 16;           // Up to the maze path
+        static const size_t c_cbTrailer = 13;
+
+        void WriteRun();
+        bool ReadRun();
+
+        // Recording
+        SDL_RWops *_pFile;
+        Uint8 _runInput;
+        Uint32 _cRun;
+
+        // Playback
+        Uint8 *_pData;
+        size_t _cbData;
+        size_t _offset;
+        Uint8 _playInput;
+        Uint32 _cPlayRemaining;
+        Uint32 _cTicksTotal;
+        Uint64 _checksum;
+        Options _options;
+
+        bool _fAutoStart;
+        Uint32 _cTicks;
+        Uint32 _cInputs;
+    };
+}
+}
@@ -1,6 +1,11 @@
 #pragma once
 #include "constants.h"
+#include "utils.h"
 #include "tiledmap.h"
+#include "pathtable.h"
+#include "pathhierarchy.h"
+#include "mazeattributes.h"
+#include "pelletboard.h"
 
 namespace XplatGameTutorial
 {
@@ -10,68 +15,110 @@ namespace PacManClone
 
     // Derived class that adds information to the TiledMap specific to the PacManClone
     // maze, such as collision detection with walls and pellets.
+    //
+    // Everything the game asks about a tile is precomputed into one packed attribute per tile
+    // (MazeAttributes, built at compile time for the classic maze and when a MazePack is written
+    // for the rest), so each query is a single indexed load.  The pellets still to be eaten are
+    // kept separately as bitboards, which leaves the attribute table read-only so it's used
+    // straight from the layout.  Start positions, the pen and the like come from the layout too.
     class Maze : public TiledMap
     {
     public:
-        Maze(const Uint16 rows, const Uint16 cols, Uint16 cxScreen, Uint16 cyScreen) :
-            XplatGameTutorial::PacManClone::TiledMap(rows, cols, cxScreen, cyScreen)
+        Maze(const MazeLayout &layout, Uint16 cxScreen, Uint16 cyScreen) :
+            XplatGameTutorial::PacManClone::TiledMap(layout.rows, layout.cols, cxScreen, cyScreen),
+            _layout(layout),
+            _pTileAttributes(nullptr),
+            _pPathTable(nullptr),
+            _pPathHierarchy(nullptr),
+            _cPelletWords(0),
+            _cPelletsRemaining(0),
+            _pPellets(nullptr),
+            _pPowerPellets(nullptr),
+            _pStartPellets(nullptr),
+            _pStartPowerPellets(nullptr)
         {
         }
 
         virtual ~Maze()
         {
+            delete _pPathTable;
+            delete _pPathHierarchy;
+            delete[] _pPellets;
         }
 
+        // Same as the TiledMap version with the layout's tiles, and also lays out the pellets
+        bool Initialize(SDL_Rect textureRect, SDL_Rect tileRect, SDL_Texture *pTexture);
+
+        // Where everyone starts, the pen, scatter corners and so on
+        const MazeLayout& Layout() { return _layout; }
+
         SDL_bool IsTilePellet(Uint16 row, Uint16 col)
         {
-            if (GetTileIndexAt(row, col) == 16)
-            {
-                return SDL_TRUE;
-            }
-            return SDL_FALSE;
+            return PelletBoard::Test(_pPellets, Tile(row, col)) ? SDL_TRUE : SDL_FALSE;
         }
 
         SDL_bool IsTilePowerPellet(Uint16 row, Uint16 col)
         {
-            if (GetTileIndexAt(row, col) == 13)
-            {
-                return SDL_TRUE;
-            }
-            return SDL_FALSE;
+            return PelletBoard::Test(_pPowerPellets, Tile(row, col)) ? SDL_TRUE : SDL_FALSE;
         }
 
         void EatPellet(Uint16 row, Uint16 col)
         {
-            SDL_assert((GetTileIndexAt(row, col) == 16) || (GetTileIndexAt(row, col) == 13));
-            SetTileIndexAt(row, col, 49);
+            SDL_assert((IsTilePellet(row, col) == SDL_TRUE) || (IsTilePowerPellet(row, col) == SDL_TRUE));
+            PelletBoard::Reset(_pPellets, Tile(row, col));
+            PelletBoard::Reset(_pPowerPellets, Tile(row, col));
+            SetTileIndexAt(row, col, c_emptyTile);
+            _cPelletsRemaining--;
         }
 
+        // Pellets and power pellets still to be eaten, the level is done when this gets to 0
+        Uint32 PelletsRemaining() { return _cPelletsRemaining; }
+
+        // Every pellet back where it started
+        void ResetPellets() { RestorePellets(_pStartPellets, _pStartPowerPellets); }
+
         SDL_bool IsTileSolid(Uint16 row, Uint16 col)
         {
-            return (Constants::CollisionMap[
-                row * Constants::MapCols + col] == 1) ? SDL_TRUE : SDL_FALSE;
+            return HasAttribute(row, col, MazeAttributes::Solid);
         }
 
         SDL_bool IsTileIntersection(Uint16 row, Uint16 col)
         {
-            Direction directions[] = { Direction::Up, Direction::Down, Direction::Left, Direction::Right };
+            return HasAttribute(row, col, MazeAttributes::Intersection);
+        }
+
+        // Is the neighbouring cell in the given direction free to move into
+        SDL_bool CanExit(Uint16 row, Uint16 col, Direction direction)
+        {
+            return ((direction != Direction::None) && HasAttribute(row, col, ExitBit(direction))) ? SDL_TRUE : SDL_FALSE;
+        }
+
+        // Inside the ghost pen
+        SDL_bool IsTilePen(Uint16 row, Uint16 col)
+        {
+            return HasAttribute(row, col, MazeAttributes::Pen);
+        }
 
-            Uint16 exitsFound = 0;
-            // We can stop if we find at least 3 (we will always have 1 - the direction we came)
-            for (size_t index = 0; index < SDL_arraysize(directions) && exitsFound < 3; index++)
+        // How far into the warp tunnel a tile is, 1 being the outermost column at either end,
+        // 0 if the tile isn't part of the tunnel
+        Uint16 WarpDepth(Uint16 row, Uint16 col)
+        {
+            return (Attributes(row, col) & MazeAttributes::WarpDepthMask) >> MazeAttributes::WarpDepthShift;
+        }
+
+        // Precompute shortest paths between every pair of walkable tiles (optional, for the true pathing AI).
+        // Mazes too big for that get a PathHierarchy instead
+        void BuildPathTable();
+
+        // Exit that starts the shortest path from [row][col] to the target without reversing the given
+        // heading.  None if BuildPathTable hasn't been called or there's no useful answer (already at the target)
+        Direction PathDirection(Uint16 row, Uint16 col, Direction heading, Uint16 targetRow, Uint16 targetCol)
+        {
+            if (_pPathTable != nullptr)
             {
-                Uint16 nextRow = 0;
-                Uint16 nextCol = 0;
-                GetNextCell(row, col, nextRow, nextCol, directions[index]);
-                if (!IsTileSolid(nextRow, nextCol))
-                {
-                    exitsFound++;
-                }
+                return _pPathTable->NextDirection(row, col, heading, targetRow, targetCol);
             }
-
-            // Always should be at least 1 found
-            SDL_assert(exitsFound > 0);
-            return (exitsFound >= 3) ? SDL_TRUE : SDL_FALSE;
+            return (_pPathHierarchy != nullptr) ? _pPathHierarchy->NextDirection(row, col, heading, targetRow, targetCol) : Direction::None;
         }
 
         void GetNextCell(Uint16 row, Uint16 col, Uint16 &nextRow, Uint16 &nextCol, Direction direction)
@@ -106,32 +153,65 @@ namespace PacManClone
             TiledMap::Render(pSDLRenderer);
         }
 
-        SDL_bool IsSpritePastCenter(Uint16 row, Uint16 col, Sprite* pSprite)
+        SDL_bool IsSpritePastCenter(Uint16 row, Uint16 col, Sprite* pSprite);
+
+        // The pellet layer for a GameSnapshot, only mazes up to Constants::MaxSnapshotTiles fit.
+        // The tiles drawn are worked out from the bits, so restoring only redraws the tiles whose
+        // pellet came or went
+        size_t TileCount() { return static_cast<size_t>(_cRows) * _cCols; }
+        void SavePellets(PelletBoard *pPellets, PelletBoard *pPowerPellets)
+        {
+            SDL_assert(_cPelletWords <= PelletBoard::c_cWords);
+            pPellets->Clear();
+            pPowerPellets->Clear();
+            SDL_memcpy(pPellets->words, _pPellets, _cPelletWords * sizeof(Uint64));
+            SDL_memcpy(pPowerPellets->words, _pPowerPellets, _cPelletWords * sizeof(Uint64));
+        }
+        void RestorePellets(const PelletBoard &pellets, const PelletBoard &powerPellets)
+        {
+            SDL_assert(_cPelletWords <= PelletBoard::c_cWords);
+            RestorePellets(pellets.words, powerPellets.words);
+        }
+
+    private:
+        // Tiles on the texture for the pellets and for an eaten one
+        static const Uint16 c_pelletTile = 16;
+        static const Uint16 c_powerPelletTile = 13;
+        static const Uint16 c_emptyTile = 49;
+        static const Uint32 c_maxPathTableTiles = 2048;    // Bigger mazes use a PathHierarchy
+
+        size_t Tile(Uint16 row, Uint16 col)
         {
-            SDL_bool result = SDL_FALSE;
+            SDL_assert((row < _cRows) && (col < _cCols));
+            return (static_cast<size_t>(row) * _cCols) + col;
+        }
 
-            // This returns the center pixel which is useful here
-            SDL_Point centerPoint = GetTileCoordinates(row, col);
+        // _cPelletWords of each
+        void RestorePellets(const Uint64 *pPellets, const Uint64 *pPowerPellets);
 
-            // Now based on the direction, are we ahead of or behind that center pixel?
-            if (pSprite->DX() < 0)
-            {
-                result = (pSprite->X() <= centerPoint.x) ? SDL_TRUE : SDL_FALSE;
-            }
-            else if (pSprite->DX() > 0)
-            {
-                result = (pSprite->X() > centerPoint.x) ? SDL_TRUE : SDL_FALSE;
-            }
-            else if (pSprite->DY() < 0)
-            {
-                result = (pSprite->Y() <= centerPoint.y) ? SDL_TRUE : SDL_FALSE;
-            }
-            else if (pSprite->DY() > 0)
-            {
-                result = (pSprite->Y() > centerPoint.y) ? SDL_TRUE : SDL_FALSE;
-            }
-            return result;
+        static Uint16 ExitBit(Direction direction) { return static_cast<Uint16>(MazeAttributes::ExitUp << static_cast<int>(direction)); }
+
+        Uint16 Attributes(Uint16 row, Uint16 col)
+        {
+            SDL_assert((row < _cRows) && (col < _cCols));
+            return _pTileAttributes[Tile(row, col)];
         }
+
+        SDL_bool HasAttribute(Uint16 row, Uint16 col, Uint16 attribute)
+        {
+            return ((Attributes(row, col) & attribute) != 0) ? SDL_TRUE : SDL_FALSE;
+        }
+
+        MazeLayout _layout;         // Layers not owned
+        const Uint16 *_pTileAttributes; // Packed per tile MazeAttributes, same layout as the map indicies (not owned)
+        PathTable *_pPathTable;     // All pairs next step table, only built for the true pathing AI
+        PathHierarchy *_pPathHierarchy; // ...or this on big mazes
+        size_t _cPelletWords;       // Words of each pellet layer, one bit per tile (see PelletBoard)
+        Uint32 _cPelletsRemaining;
+        Uint64 *_pPellets;          // Pellets not eaten yet, one allocation holds both layers
+        Uint64 *_pPowerPellets;     // ...and power pellets
+        const Uint64 *_pStartPellets; // Both as the level starts, the layout's (not owned)
+        const Uint64 *_pStartPowerPellets;
     };
 }
-}
\ No newline at end of file
+}
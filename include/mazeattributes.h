@@ -0,0 +1,106 @@
+#pragma once
+#include "constants.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Everything the game asks about a maze tile packed into one value: walls, pellets, which
+    // neighbours can be moved into, whether it's a branch point for the ghosts, and the special
+    // regions (pen, warp tunnel).
+    //
+    // ForTile is constexpr (and so written in the C++11 single expression style) so the table for
+    // the built in map can be generated at compile time, see Constants::MapAttributes.  Other mazes
+    // have theirs built when they're written to a MazePack.
+    class MazeAttributes
+    {
+    public:
+        // The exits come first and follow the Direction enum order
+        static const Uint16 ExitUp = 0x0001;
+        static const Uint16 ExitDown = 0x0002;
+        static const Uint16 ExitLeft = 0x0004;
+        static const Uint16 ExitRight = 0x0008;
+        static const Uint16 Exits = 0x000F;
+        static const Uint16 Solid = 0x0010;
+        static const Uint16 Intersection = 0x0020;
+        static const Uint16 Pellet = 0x0040;
+        static const Uint16 PowerPellet = 0x0080;
+        static const Uint16 Pen = 0x0100;
+        static const Uint16 WarpDepthMask = 0x0600;
+        static const Uint16 WarpDepthShift = 9;
+
+        // pCollisionMap - 1 for walls, 0 for open tiles
+        // pMapIndicies - tile indices, used to find the pellets
+        // pen - inside of the ghost pen
+        // fWarpRow - the row is a warp tunnel
+        static constexpr Uint16 ForTile(const Uint16 *pCollisionMap, const Uint16 *pMapIndicies, int rows, int cols, int row, int col,
+            const MazeLayout::Region &pen, bool fWarpRow)
+        {
+            return static_cast<Uint16>(
+                ((pCollisionMap[(row * cols) + col] == 1) ? Solid : WithIntersection(OpenExits(pCollisionMap, rows, cols, row, col, fWarpRow))) |
+                ((pMapIndicies[(row * cols) + col] == 16) ? Pellet : 0) |
+                ((pMapIndicies[(row * cols) + col] == 13) ? PowerPellet : 0) |
+                (IsPen(pen, row, col) ? Pen : 0) |
+                (fWarpRow ? WarpDepth(col < cols - 1 - col ? col + 1 : cols - col) : 0));
+        }
+
+        // Every tile of a layout at run time, into pAttributes (rows * cols).  Returns the number
+        // of pellets and power pellets
+        static Uint32 BuildTable(const MazeLayout &layout, Uint16 *pAttributes)
+        {
+            Uint32 cPellets = 0;
+            for (int row = 0; row < layout.rows; row++)
+            {
+                bool fWarpRow = layout.IsWarpRow(static_cast<Uint16>(row));
+                for (int col = 0; col < layout.cols; col++)
+                {
+                    Uint16 attributes = ForTile(layout.pCollision, layout.pTiles, layout.rows, layout.cols, row, col, layout.pen, fWarpRow);
+                    cPellets += ((attributes & (Pellet | PowerPellet)) != 0) ? 1 : 0;
+                    pAttributes[(static_cast<size_t>(row) * layout.cols) + col] = attributes;
+                }
+            }
+            return cPellets;
+        }
+
+    private:
+        // Off the edge of the map is only open off either end of a warp tunnel, which wraps around.
+        // The sprites can't wrap vertically so above and below the map is always closed
+        static constexpr bool IsOpen(const Uint16 *pCollisionMap, int rows, int cols, int row, int col, bool fWarpRow)
+        {
+            return ((col < 0) || (col >= cols)) ? fWarpRow :
+                (row >= 0) && (row < rows) && (pCollisionMap[(row * cols) + col] == 0);
+        }
+
+        static constexpr Uint16 OpenExits(const Uint16 *pCollisionMap, int rows, int cols, int row, int col, bool fWarpRow)
+        {
+            return static_cast<Uint16>(
+                (IsOpen(pCollisionMap, rows, cols, row - 1, col, false) ? ExitUp : 0) |
+                (IsOpen(pCollisionMap, rows, cols, row + 1, col, false) ? ExitDown : 0) |
+                (IsOpen(pCollisionMap, rows, cols, row, col - 1, fWarpRow) ? ExitLeft : 0) |
+                (IsOpen(pCollisionMap, rows, cols, row, col + 1, fWarpRow) ? ExitRight : 0));
+        }
+
+        static constexpr int CountBits(Uint16 bits)
+        {
+            return (bits == 0) ? 0 : (bits & 1) + CountBits(static_cast<Uint16>(bits >> 1));
+        }
+
+        // 3 or more ways out means a choice has to be made
+        static constexpr Uint16 WithIntersection(Uint16 exits)
+        {
+            return static_cast<Uint16>(exits | ((CountBits(exits) >= 3) ? Intersection : 0));
+        }
+
+        static constexpr bool IsPen(const MazeLayout::Region &pen, int row, int col)
+        {
+            return (row >= pen.top) && (row <= pen.bottom) && (col >= pen.left) && (col <= pen.right);
+        }
+
+        // Depth 1 is the outermost column at either end
+        static constexpr Uint16 WarpDepth(int depth)
+        {
+            return static_cast<Uint16>((depth <= Constants::WarpTunnelDepth) ? ((depth << WarpDepthShift) & WarpDepthMask) : 0);
+        }
+    };
+}
+}
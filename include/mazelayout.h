@@ -0,0 +1,68 @@
+#pragma once
+#include "SDL.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Everything that makes one maze different from another: its size, the layers, where
+    // everyone starts, the ghost pen, the scatter corners and the warp tunnels.  It's a view, the
+    // layers aren't owned and have to outlive anything built from it.  The built in maze is
+    // Constants::ClassicMaze, others come out of a MazePack.
+    struct MazeLayout
+    {
+        struct Cell
+        {
+            Uint16 row;
+            Uint16 col;
+        };
+
+        // Inclusive tile bounds
+        struct Region
+        {
+            Uint16 top;
+            Uint16 left;
+            Uint16 bottom;
+            Uint16 right;
+        };
+
+        // Walking off one end comes out at the other.  The sprites can only wrap horizontally,
+        // so both ends are on the same row, at the left and right edges
+        struct WarpPair
+        {
+            Cell from;
+            Cell to;
+        };
+
+        static const size_t c_cGhosts = 4;      // Blinky, Pinky, Inky, Clyde
+
+        Uint16 rows;
+        Uint16 cols;
+        const Uint16 *pTiles;                   // rows * cols, row major, indices into the tiles texture
+        const Uint16 *pCollision;               // 1 for walls, 0 for open tiles
+        const Uint16 *pAttributes;              // MazeAttributes of each tile, worked out from the above
+        Uint32 cPellets;                        // Pellets and power pellets on the tile layer
+        const Uint64 *pPellets;                 // One bit per tile (see PelletBoard), the pellets the level starts with
+        const Uint64 *pPowerPellets;            // ...and the power pellets
+        Cell playerStart;                       // The player starts on the line between this and the next column
+        Cell ghostStarts[c_cGhosts];
+        Cell scatterTargets[c_cGhosts];
+        Region pen;                             // Inside of the ghost pen
+        Cell penExit;                           // Released ghosts go straight up to here from the bottom of the pen
+        const WarpPair *pWarps;
+        Uint16 cWarps;
+
+        bool IsWarpRow(Uint16 row) const
+        {
+            for (Uint16 i = 0; i < cWarps; i++)
+            {
+                if (pWarps[i].from.row == row)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+}
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "constants.h"
+#include "utils.h"
+#include "mazelayout.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Lots of mazes in one file, used straight out of a memory map: picking a maze is checking
+    // its record and filling in a MazeLayout that points at its layers, with nothing parsed or
+    // copied, so the layers' pages are only read in as the game gets to them.  The attribute layer
+    // and the starting pellets are worked out when the pack is written, which is also when every
+    // tile is checked; the layers are trusted after that unless a load asks for them to be
+    // verified (--verify-maze), which is a pass over every tile.
+    //
+    // File layout (native byte order):
+    //   Header
+    //   Header::cMazes Uint64 offsets of the mazes from the start of the file
+    //   each maze, starting on an 8 byte boundary:
+    //     Record
+    //     Record::cWarps MazeLayout::WarpPair
+    //     rows * cols Uint16 each of tiles, collision, attributes
+    //     padding to an 8 byte boundary
+    //     PelletBoard::WordsFor(rows * cols) Uint64 each of pellets, power pellets
+    class MazePack
+    {
+    public:
+        struct Header
+        {
+            char magic[4];              // "PMCM"
+            Uint32 version;
+            Uint32 cMazes;
+            Uint32 reserved;
+        };
+
+        struct Record
+        {
+            Uint16 rows;
+            Uint16 cols;
+            Uint16 cWarps;
+            Uint16 reserved;
+            Uint32 cPellets;
+            MazeLayout::Cell playerStart;
+            MazeLayout::Cell ghostStarts[MazeLayout::c_cGhosts];
+            MazeLayout::Cell scatterTargets[MazeLayout::c_cGhosts];
+            MazeLayout::Region pen;
+            MazeLayout::Cell penExit;
+        };
+
+        MazePack() : _pHeader(nullptr) { }
+
+        // Map the pack and check the header, the mazes are checked as they're asked for
+        bool Open(const char *pszPath);
+        void Close();
+        bool IsOpen() { return _pHeader != nullptr; }
+
+        Uint32 Count() { return (_pHeader != nullptr) ? _pHeader->cMazes : 0; }
+
+        // Point pLayout at maze iMaze, false if it's out of range or doesn't make sense.  fVerify
+        // checks the layers too, not just the record.  The layers are only valid while the pack is open
+        bool GetLayout(Uint32 iMaze, MazeLayout *pLayout, bool fVerify = false);
+
+        // Write out cLayouts mazes.  Only their tile and collision layers are used, the
+        // attributes and pellets are worked out here
+        static bool Write(const char *pszPath, const MazeLayout *pLayouts, Uint32 cLayouts);
+
+    private:
+        static const Uint32 c_version = 3;             // 2: 32 bit pellet count, 3: baked starting pellets
+
+        // Everything that has to hold for the game to play a maze without checking as it goes,
+        // split into the record (checked on every load) and the tiles (checked when written)
+        static bool IsPlayable(const MazeLayout &layout);
+        static bool HasPlayableTiles(const MazeLayout &layout);
+        // The attributes and pellets are what Write() would have worked out
+        static bool HasAttributes(const MazeLayout &layout);
+
+        MappedFile _file;
+        const Header *_pHeader;         // Start of the mapped file, null if not open
+    };
+}
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include "utils.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Shortest paths for the true pathing ghost AI on mazes too big for the all-pairs PathTable.  The
+    // maze is cut into 16x16 clusters and the places a corridor crosses from one cluster into the next
+    // become the nodes of a much smaller graph, joined by the crossings and by the distance between
+    // each pair of nodes inside a cluster (hierarchical pathfinding, HPA*).  A decision is a breadth
+    // first search of the ghost's own cluster out to its nodes, plus how far each of those is from the
+    // target over the small graph.
+    //
+    // Those distances come from a search backwards from the target that is only taken as far as the
+    // ghost asking needs, then kept: the next ghost after the same target picks it up where it left
+    // off, usually with nothing left to do.  A handful of targets are kept at once, so the ghosts of
+    // one personality (who all chase the same tile) and the classic four share their searches.
+    //
+    // Compared with PathTable, crossings wider than a few tiles only get a node at each end and the
+    // no reversing rule is only applied to the first move, so paths are very nearly shortest rather
+    // than exactly.  Moves are assumed to be two way.  Node and tile numbers are 32 bit, enough for
+    // the biggest maze the game loads (Constants::MaxMazeSide a side).
+    class PathHierarchy
+    {
+    public:
+        PathHierarchy();
+        ~PathHierarchy();
+
+        // Same arguments as PathTable::Build, fails if the start isn't walkable
+        bool Build(Uint16 rows, Uint16 cols, const Uint8 *pExitMasks, Uint16 startRow, Uint16 startCol);
+
+        // Same as PathTable::NextDirection, except that very occasionally (a junction whose way to the
+        // target doubles back through it) None comes back for a target that can be reached
+        Direction NextDirection(Uint16 row, Uint16 col, Direction heading, Uint16 targetRow, Uint16 targetCol);
+
+        Uint32 NodeCount() { return _cNodes; }
+
+    private:
+        static const int c_clusterShift = 4;
+        static const Uint16 c_clusterSide = 1 << c_clusterShift;
+        static const Uint16 c_clusterMask = c_clusterSide - 1;
+        static const Uint32 c_clusterTiles = c_clusterSide * c_clusterSide;
+        static const Uint16 c_longCrossing = 6;        // Crossings this wide get a node at each end
+        static const size_t c_cSearches = 8;           // Targets kept at once
+        static const Uint32 c_invalid = 0xFFFFFFFF;
+        static const Uint16 c_unreachedLocal = 0xFFFF;
+
+        // Between two nodes, cost in moves.  Crossings carry the direction they're made in, edges
+        // inside a cluster have None
+        struct Edge
+        {
+            Uint32 node;
+            Uint16 cost;
+            Uint8 direction;
+        };
+
+        struct Crossing
+        {
+            Uint32 fromTile;
+            Uint32 toTile;
+            Direction direction;
+        };
+
+        // A search backwards from one target over the nodes, carried on as far as needed
+        struct Search
+        {
+            Uint32 goalTile;            // c_invalid if unused
+            Uint32 lastUsed;
+            Uint32 *pDistance;          // Per node, moves to the goal (final once settled)
+            Uint8 *pSettled;
+            Uint32 *pHeapIndex;         // Per node, where it is in the heap, c_invalid if it isn't
+            Uint32 *pHeap;              // Binary heap of nodes, closest first
+            Uint32 cHeap;
+        };
+
+        Uint32 NeighbourTile(Uint32 tile, Direction direction);
+        Uint32 ClusterOf(Uint32 tile)
+        {
+            Uint32 row = tile / _cCols;
+            Uint32 col = tile % _cCols;
+            return ((row >> c_clusterShift) * _cClusterCols) + (col >> c_clusterShift);
+        }
+        static Uint32 LocalIndex(Uint32 row, Uint32 col) { return ((row & c_clusterMask) << c_clusterShift) + (col & c_clusterMask); }
+        Uint32 LocalIndex(Uint32 tile) { return LocalIndex(tile / _cCols, tile % _cCols); }
+
+        void BuildNearestTiles();
+        Uint32 FindCrossings(Crossing *pCrossings);
+        Uint32 AddCrossings(Crossing *pCrossings, Uint32 cCrossings, Uint32 fromRow, Uint32 fromCol, Direction direction, Uint32 cRun);
+        void BuildEdges(const Crossing *pCrossings, Uint32 cCrossings, Uint32 *pTileNodes);
+        void SearchCluster(Uint32 tile, Direction heading);
+
+        Search& SearchFor(Uint32 goalTile);
+        static bool IsCloser(const Search &search, Uint32 node, Uint32 other)
+        {
+            return (search.pDistance[node] < search.pDistance[other]) ||
+                ((search.pDistance[node] == search.pDistance[other]) && (node < other));
+        }
+        void Push(Search &search, Uint32 node);
+        Uint32 SettleNext(Search &search);
+
+        Uint16 _cRows;
+        Uint16 _cCols;
+        Uint32 _cClusterCols;
+        Uint32 _cClusters;
+        Uint8 *_pExits;                 // Exit masks of the playing area, 0 everywhere else
+        Uint32 *_pNearestTiles;         // Tile -> closest playing area tile, for targets that aren't
+        Uint32 _cNodes;
+        Uint32 *_pNodeTiles;            // Node -> tile, numbered a cluster at a time
+        Uint32 *_pClusterNodes;         // Cluster -> its first node, one extra at the end
+        Uint32 *_pEdgeStart;            // Node -> its first edge, one extra at the end
+        Edge *_pEdges;
+        Uint32 _cEdges;
+        Search _searches[c_cSearches];
+        Uint32 _cQueries;               // For picking the least recently used search
+
+        // The last cluster search, by LocalIndex
+        Uint16 _localDistance[c_clusterTiles];
+        Uint8 _localFirstMove[c_clusterTiles];
+        Uint32 _localQueue[c_clusterTiles];
+    };
+}
+}
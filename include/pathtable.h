@@ -0,0 +1,55 @@
+#pragma once
+#include "utils.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // All-pairs "which way next" table over the walkable tiles of a maze, used for the optional true
+    // pathing ghost AI.  For every target tile and every state a ghost can be in (the tile plus the
+    // heading it arrived with, since ghosts may not reverse) it holds the exit that starts a shortest
+    // path to the target.  Entries are packed 2 bits apiece and built once per maze with a breadth
+    // first search per target, after which any decision is a single lookup.
+    class PathTable
+    {
+    public:
+        PathTable();
+        ~PathTable();
+
+        // rows, cols - size of the map
+        // pExitMasks - per tile bits (1 << Direction) for each neighbour that can be moved into, edges wrap
+        // startRow, startCol - a tile in the playing area, anything not connected to it is left out (ghost pen)
+        // Fails if the start isn't walkable or the map has 64K tiles or more
+        bool Build(Uint16 rows, Uint16 cols, const Uint8 *pExitMasks, Uint16 startRow, Uint16 startCol);
+
+        // Direction to take from [row][col], having arrived heading in the given direction (None if there is
+        // no restriction), to get to the target.  Targets off the graph (walls, off the map) are swapped for
+        // the nearest walkable tile.  Returns None if [row][col] itself isn't on the graph
+        Direction NextDirection(Uint16 row, Uint16 col, Direction heading, Uint16 targetRow, Uint16 targetCol);
+
+        Uint16 NodeCount() { return _cNodes; }
+
+    private:
+        static const Uint16 c_invalidNode = 0xFFFF;
+        static const Uint32 c_headingsPerNode = 5;     // Up, Down, Left, Right, None
+
+        Uint16 NeighbourTile(Uint16 tile, Direction direction);
+        void BuildNearestNodes();
+        void SearchFromTarget(Uint16 targetNode, Uint16 *pDistance, Uint32 *pQueue);
+        void SetEntry(Uint32 index, Direction direction)
+        {
+            Uint8 shift = static_cast<Uint8>((index & 3) * 2);
+            _pNextDirections[index >> 2] = static_cast<Uint8>((_pNextDirections[index >> 2] & ~(3 << shift)) | (static_cast<int>(direction) << shift));
+        }
+
+        Uint16 _cRows;
+        Uint16 _cCols;
+        Uint16 _cNodes;                 // Walkable tiles in the playing area
+        Uint16 *_pNodeTiles;            // Node -> tile index (row * cols + col)
+        Uint16 *_pTileNodes;            // Tile -> node, c_invalidNode if not walkable
+        Uint16 *_pNearestNodes;         // Tile -> closest node, for targets that aren't walkable
+        Uint16 *_pNeighbours;           // Node -> 4 neighbouring nodes in Direction order
+        Uint8 *_pNextDirections;        // [target node][node * c_headingsPerNode + heading], 2 bits each
+    };
+}
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "SDL.h"
+#include "constants.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // One bit per maze tile, row major (bit = (row * cols) + col).  A maze keeps its pellets in
+    // words allocated for its size (see Maze), using the helpers here.  The board itself is fixed
+    // at Constants::MaxSnapshotTiles so it drops straight into a GameSnapshot; a maze only ever
+    // looks at the words its tiles cover, the classic 28x36 board is the first 16 words, so
+    // resetting a level is a 128 byte copy and how many are left is a popcount per word
+    struct PelletBoard
+    {
+        static const size_t c_cBits = Constants::MaxSnapshotTiles;
+        static const size_t c_cWords = (c_cBits + 63) / 64;
+
+        Uint64 words[c_cWords];
+
+        void Clear() { SDL_memset(words, 0, sizeof(words)); }
+
+        static bool Test(const Uint64 *pWords, size_t bit)
+        {
+            return ((pWords[bit / 64] >> (bit % 64)) & 1) != 0;
+        }
+
+        static void Set(Uint64 *pWords, size_t bit)
+        {
+            pWords[bit / 64] |= static_cast<Uint64>(1) << (bit % 64);
+        }
+
+        static void Reset(Uint64 *pWords, size_t bit)
+        {
+            pWords[bit / 64] &= ~(static_cast<Uint64>(1) << (bit % 64));
+        }
+
+        // Words needed for a maze of cTiles
+        static constexpr size_t WordsFor(size_t cTiles) { return (cTiles + 63) / 64; }
+
+        // Bits set in the first cWords
+        static Uint32 Count(const Uint64 *pWords, size_t cWords)
+        {
+            Uint32 count = 0;
+            for (size_t i = 0; i < cWords; i++)
+            {
+                count += PopCount(pWords[i]);
+            }
+            return count;
+        }
+
+        // Without the popcnt instruction enabled the compilers call out to a slow library routine,
+        // so fall back to counting in parallel within the word
+        static Uint32 PopCount(Uint64 word)
+        {
+#if defined(__POPCNT__)
+            return static_cast<Uint32>(__builtin_popcountll(word));
+#else
+            word = word - ((word >> 1) & 0x5555555555555555ULL);
+            word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+            word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            return static_cast<Uint32>((word * 0x0101010101010101ULL) >> 56);
+#endif
+        }
+
+        // Index of the lowest set bit, word can't be 0
+        static Uint32 LowestBit(Uint64 word)
+        {
+            SDL_assert(word != 0);
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+            unsigned long index = 0;
+            _BitScanForward64(&index, word);
+            return static_cast<Uint32>(index);
+#elif defined(_MSC_VER)
+            // 32 bit builds only have the 32 bit scan, try the low half first
+            unsigned long index = 0;
+            if (_BitScanForward(&index, static_cast<unsigned long>(word)))
+            {
+                return static_cast<Uint32>(index);
+            }
+            _BitScanForward(&index, static_cast<unsigned long>(word >> 32));
+            return static_cast<Uint32>(index) + 32;
+#else
+            return static_cast<Uint32>(__builtin_ctzll(word));
+#endif
+        }
+    };
+}
+}
@@ -14,7 +14,9 @@ namespace XplatGameTutorial
             // "Interface" for my ghosts to implement
             bool Initialize();
             bool Reset(Maze *pMaze);
-            Direction MakeBranchDecision(Uint16 nRow, Uint16 nCol, Player* pPlayer, Maze *pMaze);
+
+            // 4 tiles ahead of the player
+            void Update(const Blackboard &blackboard, Maze *pMaze) { Ghost::Update<PinkyTargeting>(blackboard, pMaze); }
         };
     }
 }
\ No newline at end of file
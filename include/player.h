@@ -23,6 +23,24 @@ namespace PacManClone
 
         void GetTilePlayerFacingWithOriginalBug(Maze* pMaze, Uint16 cSpaces, Uint16 &row, Uint16 &col);
 
+        struct Snapshot
+        {
+            Sprite::Snapshot sprite;
+            Uint8 mode;
+        };
+
+        void Save(Snapshot *pSnapshot)
+        {
+            Sprite::Save(&pSnapshot->sprite);
+            pSnapshot->mode = static_cast<Uint8>(_mode);
+        }
+
+        void Restore(const Snapshot &snapshot)
+        {
+            Sprite::Restore(snapshot.sprite);
+            _mode = static_cast<Mode>(snapshot.mode);
+        }
+
     private:
         // Internal state
         enum class Mode
@@ -37,11 +55,10 @@ namespace PacManClone
 
         bool IsWarpingOut(Maze* pMaze)
         {
-            SDL_Point spritePoint = { static_cast<int>(X()), static_cast<int>(Y()) };
+            SDL_Point spritePoint = { X(), Y() };
             Uint16 row, col;
-            pMaze->GetTileRowCol(spritePoint, row, col);
-            return ((row == Constants::WarpRow) && 
-                ((col == Constants::WarpColPlayerLeft) || (col == Constants::WarpColPlayerRight)));
+            return (pMaze->GetTileRowCol(spritePoint, row, col) &&
+                (pMaze->WarpDepth(row, col) == Constants::WarpDepthPlayerOut));
         }
 
         Mode _mode;
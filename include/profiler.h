@@ -0,0 +1,117 @@
+#pragma once
+#include "utils.h"
+#include "blackboard.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Lightweight frame phase profiler.  Scoped timers add the time spent in each phase of a frame,
+    // CommitFrame turns those into one sample per phase and keeps the last c_cSamples of them so we
+    // can report a rolling min/avg/p99.  When disabled a Scope is a single flag check, so it stays
+    // compiled into every build.
+    class Profiler
+    {
+    public:
+        enum class Phase
+        {
+            ProcessInput = 0,
+            PlayerUpdate,
+            PelletCollision,
+            GhostUpdate,            // One per ghost slot, GhostUpdate + slot
+            GhostUpdateLast = GhostUpdate + Blackboard::c_maxGhosts - 1,
+            CrowdUpdate,            // Party mode ghosts, all of them
+            GhostCollision,
+            MazeRender,
+            SpriteRender,
+            AITargetRender,
+            Present,
+            Count
+        };
+
+        struct PhaseStats
+        {
+            Uint32 cSamples;
+            Uint32 nsMin;
+            Uint32 nsAvg;
+            Uint32 nsP99;
+            Uint32 nsMax;
+        };
+
+        // Time the enclosing block, e.g. Profiler::Scope scope(_profiler, Profiler::Phase::Present);
+        class Scope
+        {
+        public:
+            Scope(Profiler &profiler, Phase phase) : Scope(&profiler, phase)
+            {
+            }
+
+            // For code that may not have a profiler at all
+            Scope(Profiler *pProfiler, Phase phase) :
+                _pProfiler(((pProfiler != nullptr) && pProfiler->_fEnabled) ? pProfiler : nullptr),
+                _phase(phase),
+                _start(0)
+            {
+                if (_pProfiler != nullptr)
+                {
+                    _start = SDL_GetPerformanceCounter();
+                }
+            }
+
+            ~Scope()
+            {
+                if (_pProfiler != nullptr)
+                {
+                    _pProfiler->_frameCounts[static_cast<int>(_phase)] += SDL_GetPerformanceCounter() - _start;
+                    _pProfiler->_fPhaseActive[static_cast<int>(_phase)] = true;
+                }
+            }
+
+        private:
+            Profiler *_pProfiler;
+            Phase _phase;
+            Uint64 _start;
+        };
+
+        Profiler();
+
+        void Enable(bool fEnable);
+        bool IsEnabled() { return _fEnabled; }
+        void ToggleOverlay();
+
+        // End of a frame (or tick when there's nothing to draw), record this frame's samples
+        void CommitFrame();
+
+        // Bars for each phase (avg, with min to p99 whiskers) against the 60Hz frame budget.  The
+        // numbers go to the console once a second while the overlay is up
+        void RenderOverlay(SDL_Renderer *pSDLRenderer);
+
+        // Rolling stats plus whole run min/max and average, written if anything was recorded
+        bool WriteCsv(const char *pszPath);
+
+        PhaseStats GetStats(Phase phase);
+        static const char *PhaseName(Phase phase);
+
+    private:
+        static const Uint32 c_cSamples = 240;           // 4 seconds of frames
+        static const int c_cPhases = static_cast<int>(Phase::Count);
+
+        Uint32 CountsToNanoseconds(Uint64 counts) { return static_cast<Uint32>((counts * 1000000000) / _counterFrequency); }
+        void PrintStats();
+
+        bool _fEnabled;
+        bool _fOverlay;
+        Uint64 _counterFrequency;
+        Uint64 _lastReportCounter;
+        Uint64 _frameCounts[c_cPhases];             // Accumulating for the current frame
+        bool _fPhaseActive[c_cPhases];              // Phase ran this frame
+        Uint32 _samples[c_cPhases][c_cSamples];     // Rolling window in nanoseconds
+        Uint32 _cSamples[c_cPhases];                // Valid entries in the window
+        Uint32 _iNextSample[c_cPhases];
+        Uint64 _nsRunTotal[c_cPhases];              // Whole run
+        Uint32 _cRunSamples[c_cPhases];
+        Uint32 _nsRunMin[c_cPhases];
+        Uint32 _nsRunMax[c_cPhases];
+    };
+}
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include "constants.h"
+#include "utils.h"
+#include "simulation.h"
+#include "gamesnapshot.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // Plays lots of independent games (rollouts) start to finish across every core.  Each game is
+    // a task; the games are dealt out to the workers as contiguous ranges up front and a worker
+    // that runs out steals half of what's left in someone else's range, so uneven game lengths
+    // don't leave cores idle.  Every worker has its own Simulation, clock and result buffer and
+    // nothing mutable is shared between games, so it scales with the number of cores.  The
+    // per-worker results are merged once everyone is done.
+    //
+    // A game's outcome only depends on its index (the policy gets the same inputs whichever
+    // worker runs it), so results are the same for any number of threads.
+    class RolloutFarm
+    {
+    public:
+        // Picks the input for the coming tick of game iGame.  Called on the worker threads, so
+        // anything it touches besides the simulation has to be safe to share.  pContext is the
+        // pointer handed to Run()
+        typedef Direction (*Policy)(Simulation &simulation, Uint32 iGame, Uint32 tick, void *pContext);
+
+        struct Result
+        {
+            Uint32 iGame;               // Which rollout this is
+            Uint32 cTicks;              // How long the game lasted
+            Uint32 score;               // Points scored
+            Uint16 cPelletsEaten;
+            bool fCleared;              // Ate every pellet
+            bool fCaught;               // Caught by a ghost
+        };
+
+        // Totals for the last Run()
+        struct Stats
+        {
+            Uint32 cWorkers;
+            Uint32 cSteals;             // Ranges taken from another worker
+            Uint64 cTicks;              // Ticks simulated over every game
+            Uint32 msElapsed;
+        };
+
+        RolloutFarm();
+        ~RolloutFarm();
+
+        // cWorkers - threads to use (0 == one per CPU)
+        // layout - the maze to play, it has to outlive the farm and fit a GameSnapshot (see PelletBoard)
+        bool Initialize(Uint32 cWorkers = 0, bool fTruePathing = false, const MazeLayout &layout = Constants::ClassicMaze);
+
+        // Play games [0, cGames) until caught, cleared or cMaxTicks have passed.  policy may be null,
+        // in which case the games wander at random.  pResults receives cGames results in game order
+        bool Run(Uint32 cGames, Uint32 cMaxTicks, Policy policy, void *pContext, Result *pResults);
+
+        const Stats& LastStats() { return _stats; }
+
+        // Heads in a random direction, changing it every so often (a pure function of game and tick)
+        static Direction WanderPolicy(Simulation &simulation, Uint32 iGame, Uint32 tick, void *pContext);
+
+    private:
+        struct Worker
+        {
+            RolloutFarm *pFarm;
+            SDL_Thread *pThread;
+            SDL_SpinLock lock;          // Guards next/end, the owner and thieves both take from the range
+            Uint32 next;                // Next game in our range
+            Uint32 end;                 // One past the last game in our range
+            Result *pResults;           // Only written by this worker
+            Uint32 cResults;
+            Uint32 cResultsMax;
+            Uint32 cSteals;
+            Uint64 cTicks;
+            GameClock clock;
+            Simulation simulation;      // Reset from the start snapshot for each game
+        };
+
+        static int WorkerThread(void *pData);
+        bool TakeGame(Uint32 iWorker, Uint32 *piGame);
+        bool StealGames(Uint32 iWorker);
+        void PlayGame(Worker &worker, Uint32 iGame);
+
+        Uint32 _cWorkers;
+        Worker *_pWorkers;
+        TextureWrapper *_pTilesTexture;     // Size only placeholders, nothing is drawn
+        TextureWrapper *_pSpriteTexture;
+        GameSnapshot *_pStartSnapshot;      // A game at the start of the level
+
+        // Only set for the duration of Run()
+        Uint32 _cMaxTicks;
+        Policy _policy;
+        void *_pContext;
+        Stats _stats;
+    };
+}
+}
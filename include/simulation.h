@@ -0,0 +1,127 @@
+#pragma once
+#include "constants.h"
+#include "utils.h"
+#include "maze.h"
+#include "player.h"
+#include "blinky.h"
+#include "pinky.h"
+#include "inky.h"
+#include "clyde.h"
+#include "blackboard.h"
+#include "ghoststore.h"
+#include "profiler.h"
+#include "gamesnapshot.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // The game itself with no window attached: the maze, the player, the ghosts and the rules
+    // that tie them together for one tick of play.  The GameHarness drives one of these from the
+    // keyboard and draws it, BatchEnvironment steps lots of them side by side.  Nothing in here
+    // needs SDL video, and once a level is set up Step() never touches the heap.
+    class Simulation
+    {
+    public:
+        // What happened during a Step()
+        struct StepResult
+        {
+            Uint16 cPelletsEaten;       // Pellets eaten this tick (0 or 1), power pellets included
+            bool fPowerPellet;          // ...and it was a power pellet
+            bool fPlayerCaught;         // A ghost that isn't scattering is on the player's tile
+            bool fLevelComplete;        // That was the last pellet
+        };
+
+        Simulation() :
+            _pTilesTexture(nullptr),
+            _pSpriteTexture(nullptr),
+            _pClock(nullptr),
+            _pProfiler(nullptr),
+            _pLayout(&Constants::ClassicMaze),
+            _pMaze(nullptr),
+            _pPlayer(nullptr),
+            _pBlinky(nullptr),
+            _pPinky(nullptr),
+            _pInky(nullptr),
+            _pClyde(nullptr),
+            _cCrowdGhosts(0),
+            _fTruePathing(false)
+        {
+            for (size_t i = 0; i < SDL_arraysize(_pGhosts); i++)
+            {
+                _pGhosts[i] = nullptr;
+            }
+        }
+
+        ~Simulation()
+        {
+            Cleanup();
+        }
+
+        // The textures and clock aren't owned.  When headless the textures are placeholders that
+        // only have a size, which is all the maze and sprites check.  Ghost timers run on the clock
+        void Initialize(TextureWrapper *pTilesTexture, TextureWrapper *pSpriteTexture, GameClock *pClock)
+        {
+            _pTilesTexture = pTilesTexture;
+            _pSpriteTexture = pSpriteTexture;
+            _pClock = pClock;
+        }
+
+        // Frees the maze and sprites (the maze holds a render target, so before the renderer goes)
+        void Cleanup();
+
+        // Ghosts follow precomputed shortest paths instead of the original greedy targeting
+        void SetTruePathing(bool fTruePathing) { _fTruePathing = fTruePathing; }
+        // This many more ghosts on top of the classic four (party mode), kept in a GhostStore.
+        // Call before the first InitLevel().  They aren't part of a GameSnapshot
+        void SetCrowdGhosts(size_t cGhosts) { _cCrowdGhosts = cGhosts; }
+        // Time the update phases into this profiler (optional, not owned)
+        void SetProfiler(Profiler *pProfiler) { _pProfiler = pProfiler; }
+        // Play this maze instead of the classic one (not owned, nor are its layers).  Call before
+        // the first InitLevel()
+        void SetLayout(const MazeLayout *pLayout) { SDL_assert(_pMaze == nullptr); _pLayout = pLayout; }
+
+        // All the pellets back, everyone at their starting positions.  The maze is only built the
+        // first time, after that it's a reset of the pellet layer
+        void InitLevel();
+
+        // One tick of play with the given input.  The caller advances the clock
+        StepResult Step(Direction inputDirection);
+
+        // The simulation's part of a GameSnapshot (everything except the GameHarness state machine)
+        void Save(GameSnapshot *pSnapshot);
+        void Restore(const GameSnapshot &snapshot);
+
+        Maze* GetMaze() { return _pMaze; }
+        Player* GetPlayer() { return _pPlayer; }
+        Ghost* GetGhost(size_t index) { return _pGhosts[index]; }
+        GhostStore& GetCrowd() { return _crowd; }
+        const Blackboard& GetBlackboard() { return _blackboard; }
+
+    private:
+        void InitializeSprites();
+        Uint16 HandlePelletCollision(bool *pfPowerPellet);
+        bool HandleGhostCollision();
+        void UpdateBlackboard();
+        void UpdateBlackboardGhost(size_t ghostIndex);
+        template <class T> void UpdateGhost(T *pGhost, size_t iSlot);
+
+        TextureWrapper *_pTilesTexture;     // Texture that holds the maze tiles (not owned)
+        TextureWrapper *_pSpriteTexture;    // Texture that holds the sprite frames (not owned)
+        GameClock *_pClock;                 // Simulation time (not owned)
+        Profiler *_pProfiler;               // Update phase timings (not owned, may be null)
+        const MazeLayout *_pLayout;         // The maze being played (not owned)
+        Maze *_pMaze;                       // Maze - playing area
+        Player *_pPlayer;                   // The player sprite PacManClone
+        Blinky *_pBlinky;                   // Blinky
+        Pinky  *_pPinky;                    // Pinky
+        Inky  *_pInky;                      // Inky
+        Clyde *_pClyde;                     // Clyde
+        Ghost* _pGhosts[Blackboard::c_maxGhosts];   // Stick our ghosts in here for easy access to common code
+        GhostStore _crowd;                  // Party mode ghosts
+        size_t _cCrowdGhosts;
+        Blackboard _blackboard;             // What the ghosts know about the world this tick
+        bool _fTruePathing;                 // Ghost AI uses the maze path table
+    };
+}
+}
@@ -36,15 +36,15 @@ namespace PacManClone
         // pSequence - pointer to list of frames
         // cFramesInSequence - total frames in the sequence passed in
         // animationSpeed - the delay between frame updates
-        void LoadAnimationSequence(Uint16 index, AnimationType animationType, int* pSequence, Uint16 cFramesInSequence, Uint16 animationSpeed);
+        void LoadAnimationSequence(Uint16 index, AnimationType animationType, const int* pSequence, Uint16 cFramesInSequence, Uint16 animationSpeed);
         // Start the current animation over
         void ResetAnimation();
         // Set a new (already loaded) animation sequence as the current
         void SetAnimation(Uint16 index);
-        // Set a new velocity
-        void SetVelocity(double dx, double dy);
-        // Set a new position (normally handled via Update but on death, etc)
-        void ResetPosition(double x, double y); 
+        // Set a new velocity, in fixed point pixels per update
+        void SetVelocity(Fixed dx, Fixed dy);
+        // Set a new position in whole pixels (normally handled via Update but on death, etc)
+        void ResetPosition(int x, int y);
         // This is only needed for sprites that have no animation, the frame will not update
         void SetFrame(Uint16 frameIndex);
         // Offset from the pixel (X,Y) location of the sprite for the frame (defaults to 0)
@@ -53,13 +53,18 @@ namespace PacManClone
         void SetVisible(SDL_bool visible);
         // Applies current state to the object (velocity, animation, etc)
         void Update();
-        // Draw it to the renderer
-        void Render(SDL_Renderer *pSDLRenderer);
-        // Some quick accessors
-        double X() { return _x; }
-        double Y() { return _y; }
-        double DX() { return _dx; }
-        double DY() { return _dy; }
+        // Draw it to the renderer if it's in view (TiledMap::ViewRect)
+        void Render(SDL_Renderer *pSDLRenderer, const SDL_Rect &view) { RenderAt(pSDLRenderer, X(), Y(), view); }
+        // Draw the current frame somewhere else (stand-ins that share this sprite's look)
+        void RenderAt(SDL_Renderer *pSDLRenderer, int x, int y, const SDL_Rect &view);
+        // Some quick accessors.  X() and Y() are the pixel the sprite is on, the fixed point
+        // position underneath is only needed for exact comparisons
+        int X() { return FixedToPixels(_x); }
+        int Y() { return FixedToPixels(_y); }
+        Fixed FixedX() { return _x; }
+        Fixed FixedY() { return _y; }
+        Fixed DX() { return _dx; }
+        Fixed DY() { return _dy; }
         Uint16 Width() { return _cxFrame; }
         Uint16 Height() { return _cyFrame; }
 
@@ -67,11 +72,28 @@ namespace PacManClone
         Direction CurrentDirection();
         bool IsOutOfView(SDL_Rect &rect);
 
+        // Everything about the sprite that changes while it moves.  Only the current animation's
+        // progress is kept, switching animations always starts the new one over
+        struct Snapshot
+        {
+            Fixed x;
+            Fixed y;
+            Fixed dx;
+            Fixed dy;
+            Uint16 animationIndex;
+            Uint16 animationFrame;
+            Uint16 animationCounter;
+            SDL_bool fVisible;
+        };
+
+        void Save(Snapshot *pSnapshot);
+        void Restore(const Snapshot &snapshot);
+
     protected:
-        double _x;                              // Position
-        double _y;
-        double _dx;                             // Velocity
-        double _dy;
+        Fixed _x;                               // Position
+        Fixed _y;
+        Fixed _dx;                              // Velocity
+        Fixed _dy;
         Uint16 _cFramesTotal;                   // Total number of frames to allocate
         SDL_Rect *_pFrames;                     // Frame rects in the texture
         Uint16 _cxFrame;                        // Width of a frame
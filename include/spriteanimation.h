@@ -18,7 +18,7 @@ namespace PacManClone
     class SpriteAnimation
     {
     public:
-        SpriteAnimation(Uint16 cFrames, int* pAnimationSequence, AnimationType animationType, Uint16 animationSpeed) :
+        SpriteAnimation(Uint16 cFrames, const int* pAnimationSequence, AnimationType animationType, Uint16 animationSpeed) :
             _cFrames(cFrames),
             _frameIndex(0),
             _currentAnimationCounter(0),
@@ -54,6 +54,16 @@ namespace PacManClone
         }
 
         int CurrentFrame() { return _pAnimation[_frameIndex]; }
+
+        // Where we are in the sequence, the sequence itself never changes once loaded
+        Uint16 FrameIndex() { return _frameIndex; }
+        Uint16 Counter() { return _currentAnimationCounter; }
+        void SetProgress(Uint16 frameIndex, Uint16 counter)
+        {
+            SDL_assert(frameIndex < _cFrames);
+            _frameIndex = frameIndex;
+            _currentAnimationCounter = counter;
+        }
         
         void AdvanceFrame()
         {
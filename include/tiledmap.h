@@ -1,13 +1,21 @@
 #pragma once
 #include "SDL_image.h"
+#include "tilestore.h"
 
 namespace XplatGameTutorial
 {
 namespace PacManClone
 {
     // Takes a texture divided evenly into tiles as well as a map size and a list of indices to the tiles
-    // to fill out the map.  When rendered, the map will center itself in the total window and iterate over
-    // the map, drawing the indexed tile
+    // to fill out the map.  When rendered, the map will center itself in the total window.  The tiles are
+    // baked once into a cached render-target texture, and only tiles changed since (SetTileIndexAt) are
+    // redrawn into it, so presenting the map is a single copy per frame.
+    //
+    // Maps bigger than the window scroll: the view (CenterViewOn) is the window sized part of the map
+    // on screen, and only what's inside it is drawn, so a frame costs the same however big the map
+    // is.  Everything else keeps working in map coordinates, the view only comes in when drawing.
+    // The game's own mazes stop at Constants::MaxMazeSide tiles a side, as sprite positions are Fixed.
+    // The indices themselves are in a TileStore, so only the parts of the map looked at are kept.
     class TiledMap
     {
     public:
@@ -19,12 +27,17 @@ namespace PacManClone
             _cxOffset(0),
             _cyOffset(0),
             _pTileRects(nullptr),
-            _pMapIndicies(nullptr),
             _cCols(cols),
             _cRows(rows),
             _tileSize(0),
             _pTileTexture(nullptr),
-            _cTilesOnTexture(0)
+            _cTilesOnTexture(0),
+            _pCacheTexture(nullptr),
+            _fCacheValid(false),
+            _fCacheUnsupported(false),
+            _cDirtyTiles(0),
+            _colorMod({ 255, 255, 255, 255 }),
+            _view({ 0, 0, cxScreen, cyScreen })
         {
             SDL_memset(&_textureRect, 0, sizeof(SDL_Rect));
         }
@@ -32,15 +45,38 @@ namespace PacManClone
         virtual ~TiledMap()
         {
             // Free our allocated memory
-            delete[] _pMapIndicies;
+            if (_pCacheTexture != nullptr)
+            {
+                SDL_DestroyTexture(_pCacheTexture);
+            }
             delete[] _pTileRects;
         }
 
-        // Initialize our map with the texture and map data
-        bool Initialize(SDL_Rect textureRect, SDL_Rect tileRect, SDL_Texture *pTexture, Uint16 *pMapIndices, Uint16 countOfIndicies);
+        // Initialize our map with the texture and map data.  The map data isn't copied and has to outlive
+        // the map, cbTileBudget is how much of it to keep in memory at once.  Only the tiles marked in
+        // pChangeable (see TileStore::Initialize) can be changed with SetTileIndexAt
+        bool Initialize(SDL_Rect textureRect, SDL_Rect tileRect, SDL_Texture *pTexture, const Uint16 *pMapIndices, size_t countOfIndicies,
+            size_t cbTileBudget = TileStore::c_cbDefaultBudget, const Uint64 *pChangeable = nullptr, size_t cChangeableLayers = 0);
         
+        // Create the cached map texture and draw every tile into it.  Optional, Render() will do this on
+        // first use, but calling it while loading keeps the cost out of the first frame
+        bool BakeCache(SDL_Renderer *pSDLRenderer);
+        // The cache contents are lost (e.g. SDL_RENDER_TARGETS_RESET), redraw everything next Render()
+        void InvalidateCache() { _fCacheValid = false; }
+
         // Draw to the renderer at the current offset, etc
         virtual void Render(SDL_Renderer *pSDLRenderer);
+
+        // Color modulation applied to the whole map when presented (level complete flashing)
+        void SetColorMod(Uint8 r, Uint8 g, Uint8 b) { _colorMod = { r, g, b, 255 }; }
+
+        // Scroll so the point (map coordinates) is as near the middle of the window as the edges of
+        // the map allow.  A map that fits the window never moves
+        void CenterViewOn(int x, int y);
+        // The part of the map on screen, in map coordinates.  Subtract its corner to get to the screen
+        const SDL_Rect& ViewRect() { return _view; }
+        // Where the map is on screen, clipped to the window
+        SDL_Rect GetScreenBounds();
         
         // Given an [row][col] location, return the (X,Y) coordinates on the screen
         SDL_Point GetTileCoordinates(Uint16 row, Uint16 col);
@@ -48,10 +84,44 @@ namespace PacManClone
         bool GetTileRowCol(SDL_Point &point, Uint16 &row, Uint16 &col);
         // Return the outer bounds of the map
         SDL_Rect GetMapBounds();
+
+        Uint16 Rows() { return _cRows; }
+        Uint16 Cols() { return _cCols; }
         
     protected:
-        Uint16 GetTileIndexAt(Uint16 row, Uint16 col) { return _pMapIndicies[(row * _cCols) + col]; }
-        void SetTileIndexAt(Uint16 row, Uint16 col, Uint16 index) { _pMapIndicies[(row * _cCols) + col] = index; }
+        Uint16 GetTileIndexAt(Uint16 row, Uint16 col) { return _tiles.Get(row, col); }
+        void SetTileIndexAt(Uint16 row, Uint16 col, Uint16 index)
+        {
+            _tiles.Set(row, col, index);
+            MarkTileDirty(row, col);
+        }
+
+        void MarkTileDirty(Uint16 row, Uint16 col)
+        {
+            if (_cDirtyTiles < SDL_arraysize(_dirtyTiles))
+            {
+                _dirtyTiles[_cDirtyTiles++] = { row, col };
+            }
+            else
+            {
+                // Too many changes to patch individually, just redraw the lot
+                _fCacheValid = false;
+            }
+        }
+
+        void RenderTile(SDL_Renderer *pSDLRenderer, Uint16 row, Uint16 col, int xOrigin, int yOrigin);
+        void RenderTiles(SDL_Renderer *pSDLRenderer, SDL_Rect &tiles, int xOrigin, int yOrigin);
+        // The rows and cols (x = col, w = count of cols, etc) with any part in the view
+        SDL_Rect VisibleTiles();
+        void UpdateCache(SDL_Renderer *pSDLRenderer);
+
+        struct TileLocation
+        {
+            Uint16 row;
+            Uint16 col;
+        };
+        static const size_t c_maxDirtyTiles = 32;
+        static const int c_maxCacheSide = 4096;    // Bigger maps are drawn a tile at a time, even with render targets
         
         Uint16 _cxScreen;           // Total screen (window) width in pixels
         Uint16 _cyScreen;           // Total screen height
@@ -60,13 +130,20 @@ namespace PacManClone
         Uint16 _cxOffset;           // Offset from upper left corner of window (screen)
         Uint16 _cyOffset;           // ...
         SDL_Rect* _pTileRects;      // Will hold the list of tile source rects from the texture loaded
-        Uint16 *_pMapIndicies;      // Will hold the indices to the map
+        TileStore _tiles;           // Will hold the indices to the map
         Uint16 _cCols;              // Cols in the map
         Uint16 _cRows;              // Rows in the map
         Uint16 _tileSize;           // Cached size of the tile (w == h in our implementation e.g. square tiles only)
         SDL_Rect _textureRect;      // Size of the texture
         SDL_Texture *_pTileTexture; // Texture that holds the tiles (must be evenly divisible by tile size)
         Uint16 _cTilesOnTexture;    // Total number of tiles on the texture
+        SDL_Texture *_pCacheTexture;// Render target holding the whole map (null if unsupported)
+        bool _fCacheValid;          // False until every tile has been drawn into the cache
+        bool _fCacheUnsupported;    // Renderer can't do render targets, draw tile by tile instead
+        TileLocation _dirtyTiles[c_maxDirtyTiles]; // Tiles changed since the cache was last updated
+        Uint16 _cDirtyTiles;        // ...count of the above
+        SDL_Color _colorMod;        // Modulation applied when presenting the map
+        SDL_Rect _view;             // The window sized part of the map on screen (in map coordinates)
     };
 }
 }
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+#include "SDL.h"
+
+namespace XplatGameTutorial
+{
+namespace PacManClone
+{
+    // The tile indices of a TiledMap, kept as 32x32 chunks copied out of the map's source indices
+    // when they're first touched.  The source (a maze pack layer, generated data, anything row major)
+    // isn't owned or copied up front, so a map can be far bigger than what's kept in memory - a
+    // memory-mapped file only ever gets the pages of the chunks that were looked at read in.  The
+    // biggest maze the game loads is Constants::MaxMazeSide tiles a side, about 4M tiles.
+    //
+    // At most a budget's worth of chunks is kept, the one not looked at for longest going when
+    // another is needed (the clock approximation of least recently used).  Changed chunks (Set)
+    // can't be read back from the source so they always stay, which is why the tiles that can be
+    // changed are given up front: the budget is raised so every chunk holding one of them fits
+    // with room to spare, and nothing is allocated after Initialize.
+    class TileStore
+    {
+    public:
+        static const size_t c_cbDefaultBudget = 4 * 1024 * 1024;
+
+        TileStore() :
+            _pSource(nullptr),
+            _cRows(0),
+            _cCols(0),
+            _cChunkCols(0),
+            _pResident(nullptr),
+            _pPool(nullptr),
+            _cPool(0),
+            _cChunks(0),
+            _iClock(0)
+        {
+        }
+        ~TileStore();
+
+        // pSource is rows * cols indices and has to outlive the store.  pChangeable is
+        // cChangeableLayers bitboards one after the other (see PelletBoard), the tiles Set can be
+        // called on, null if it never is.  The chunks are all allocated here so looking tiles up
+        // or changing them never allocates
+        void Initialize(const Uint16 *pSource, Uint16 rows, Uint16 cols, size_t cbBudget,
+            const Uint64 *pChangeable, size_t cChangeableLayers);
+
+        Uint16 Get(Uint16 row, Uint16 col)
+        {
+            return ChunkFor(row, col).tiles[((row & c_chunkMask) << c_chunkShift) + (col & c_chunkMask)];
+        }
+        void Set(Uint16 row, Uint16 col, Uint16 index)
+        {
+            Chunk &chunk = ChunkFor(row, col);
+            chunk.tiles[((row & c_chunkMask) << c_chunkShift) + (col & c_chunkMask)] = index;
+            chunk.fChanged = true;
+        }
+
+        size_t ResidentBytes() { return _cChunks * sizeof(Chunk); }
+
+    private:
+        static const int c_chunkShift = 5;
+        static const Uint16 c_chunkSide = 1 << c_chunkShift;
+        static const Uint16 c_chunkMask = c_chunkSide - 1;
+
+        struct Chunk
+        {
+            Uint16 tiles[c_chunkSide * c_chunkSide];
+            size_t iChunk;              // Which chunk of the map this is
+            bool fReferenced;           // Looked at since the clock last went past
+            bool fChanged;              // Set() since it was read, never evicted
+        };
+
+        Chunk& ChunkFor(Uint16 row, Uint16 col)
+        {
+            size_t iChunk = (static_cast<size_t>(row >> c_chunkShift) * _cChunkCols) + (col >> c_chunkShift);
+            Uint32 slot = _pResident[iChunk];
+            if (slot == 0)
+            {
+                slot = Load(iChunk);
+            }
+            Chunk &chunk = _pPool[slot - 1];
+            chunk.fReferenced = true;
+            return chunk;
+        }
+
+        // Read a chunk from the source, returns its slot + 1
+        Uint32 Load(size_t iChunk);
+        size_t CountChangeableChunks(const Uint64 *pChangeable, size_t cChangeableLayers);
+        bool Evict(size_t *pSlot);
+        void Cleanup();
+
+        const Uint16 *_pSource;         // Not owned
+        Uint16 _cRows;
+        Uint16 _cCols;
+        size_t _cChunkCols;
+        Uint32 *_pResident;             // Slot + 1 of each chunk of the map, 0 when it isn't loaded
+        Chunk *_pPool;                  // The budget's worth of chunks, loaded ones first
+        size_t _cPool;
+        size_t _cChunks;                // ...count in use
+        size_t _iClock;                 // Next slot to look at for eviction
+    };
+}
+}
@@ -1,35 +1,89 @@
 #pragma once
 #include "SDL.h"
+#include "constants.h"
 #include <stdio.h>
 
 namespace XplatGameTutorial
 {
 namespace PacManClone
 {
-    // Oneshot timer for state transistions
+    // Counts simulation ticks.  Anything that waits on game time reads this instead of the wall
+    // clock, so a headless or uncapped run covers exactly the same game time per tick as a real
+    // time one and every run comes out the same
+    class GameClock
+    {
+    public:
+        GameClock() : _cTicks(0)
+        {
+        }
+
+        void Tick() { _cTicks++; }
+        void Reset() { _cTicks = 0; }
+        void SetTicks(Uint32 cTicks) { _cTicks = cTicks; }
+        Uint32 Ticks() { return _cTicks; }
+
+        // Elapsed game time in ms, derived purely from the tick count
+        Uint32 Milliseconds()
+        {
+            return static_cast<Uint32>((static_cast<Uint64>(_cTicks) * 1000) / Constants::FramesPerSecond);
+        }
+
+    private:
+        Uint32 _cTicks;
+    };
+
+    // Oneshot timer for state transistions.  Runs on the injected GameClock, or the wall
+    // clock (SDL_GetTicks) if none was set
     class StateTimer
     {
     public:
-        StateTimer() : _startTicks(0), _targetTicks(0), _fStarted(false)
+        StateTimer() : _startTicks(0), _targetTicks(0), _fStarted(false), _pClock(nullptr)
         {
         }
 
+        void SetClock(GameClock *pClock) { _pClock = pClock; }
+
         void Start(Uint32 waitTicks)
         {
             SDL_assert(!_fStarted);
             SDL_assert(_startTicks == 0);
-            _startTicks = SDL_GetTicks();
+            _startTicks = Now();
             _targetTicks = waitTicks;
             _fStarted = true;
         }
 
         void Reset() { _fStarted = false; _startTicks = 0; }
         bool IsStarted() { return _fStarted; }
-        bool IsDone() { return IsStarted() && (SDL_GetTicks() - _startTicks > _targetTicks); }
+        bool IsDone() { return IsStarted() && (Now() - _startTicks > _targetTicks); }
+
+        // Progress of the timer as plain data (see GameSnapshot)
+        struct Snapshot
+        {
+            Uint32 startTicks;
+            Uint32 targetTicks;
+            bool fStarted;
+        };
+
+        void Save(Snapshot *pSnapshot)
+        {
+            pSnapshot->startTicks = _startTicks;
+            pSnapshot->targetTicks = _targetTicks;
+            pSnapshot->fStarted = _fStarted;
+        }
+
+        void Restore(const Snapshot &snapshot)
+        {
+            _startTicks = snapshot.startTicks;
+            _targetTicks = snapshot.targetTicks;
+            _fStarted = snapshot.fStarted;
+        }
     private:
+        Uint32 Now() { return (_pClock != nullptr) ? _pClock->Milliseconds() : SDL_GetTicks(); }
+
         Uint32 _startTicks;
         Uint32 _targetTicks;
         bool _fStarted;
+        GameClock *_pClock;     // Not owned
     };
 
     // Simple enum to denote the 4 possible directions
@@ -60,6 +114,17 @@ namespace PacManClone
     // Sets up our SDL environment and Window
     bool InitializeSDL(SDL_Window **ppSDLWindow, SDL_Renderer **ppSDLRenderer);
 
+    // SDL_image, only needed to load PNGs
+    bool InitializeSDLImage();
+
+    // Sets up only the SDL subsystems the simulation needs (no video, no window)
+    bool InitializeSDLHeadless();
+
+#ifndef NDEBUG
+    // Debug builds count every global operator new, so hot paths can be checked for heap churn
+    Uint32 HeapAllocationCount();
+#endif
+
     // TODO - helper to calculate distance between 2 cells
     double Distance(Uint16 row1, Uint16 col1, Uint16 row2, Uint16 col2);
 
@@ -77,9 +142,24 @@ namespace PacManClone
         }
 
         TextureWrapper(const char *szFileName, size_t cchFileName, SDL_Renderer *pSDLRenderer, SDL_Color *pSdlTransparencyColorKey);
+
+        // Takes ownership of a texture created elsewhere (e.g. from an AssetPack)
+        TextureWrapper(SDL_Texture *pTexture, const char *szName, size_t cchName);
+
+        // Headless placeholder - no texture is loaded, but the size is known so frame
+        // and tile rects can still be validated against it
+        TextureWrapper(int cxTexture, int cyTexture) : TextureWrapper()
+        {
+            _cxTexture = cxTexture;
+            _cyTexture = cyTexture;
+        }
         
         ~TextureWrapper();
 
+        // Takes ownership of pTexture in place of whatever we had, e.g. once a placeholder's
+        // texture has finished streaming in (see AssetLoader)
+        void SetTexture(SDL_Texture *pTexture, const char *szName);
+
         // Accessors
         bool IsNull() { return _pTexture == nullptr; }
         int Width() { return _cxTexture;  }
@@ -92,5 +172,33 @@ namespace PacManClone
         int _cyTexture;
         char *_pszFilename;
     };
+
+    // A whole file mapped read only (mmap, or a file mapping on Windows).  The asset and maze
+    // packs are used straight out of one of these, nothing is read or copied up front and the
+    // OS pages in only what gets touched
+    class MappedFile
+    {
+    public:
+        MappedFile();
+        ~MappedFile() { Close(); }
+
+        // False if the file doesn't exist, is empty or can't be mapped
+        bool Open(const char *pszPath);
+        void Close();
+        bool IsOpen() { return _pData != nullptr; }
+
+        const Uint8* Data() { return _pData; }
+        size_t Size() { return _cbData; }
+
+    private:
+        const Uint8 *_pData;
+        size_t _cbData;
+#ifdef _WIN32
+        void *_hFile;
+        void *_hMapping;
+#else
+        int _fd;
+#endif
+    };
 }
 }
@@ -0,0 +1,240 @@
+#include "include/inputreplay.h"
+
+using namespace XplatGameTutorial::PacManClone;
+
+InputReplay::InputReplay() :
+    _pFile(nullptr),
+    _runInput(0),
+    _cRun(0),
+    _pData(nullptr),
+    _cbData(0),
+    _offset(0),
+    _playInput(0),
+    _cPlayRemaining(0),
+    _cTicksTotal(0),
+    _checksum(0),
+    _fAutoStart(false),
+    _cTicks(0),
+    _cInputs(0)
+{
+    SDL_memset(&_options, 0, sizeof(_options));
+}
+
+namespace
+{
+    void WriteUint(Uint8 *pBuffer, Uint32 value, int cb)
+    {
+        for (int i = 0; i < cb; i++)
+        {
+            pBuffer[i] = static_cast<Uint8>(value >> (8 * i));
+        }
+    }
+
+    Uint32 ReadUint(const Uint8 *pBuffer, int cb)
+    {
+        Uint32 value = 0;
+        for (int i = 0; i < cb; i++)
+        {
+            value |= static_cast<Uint32>(pBuffer[i]) << (8 * i);
+        }
+        return value;
+    }
+}
+
+InputReplay::~InputReplay()
+{
+    if (_pFile != nullptr)
+    {
+        SDL_RWclose(_pFile);
+    }
+    delete[] _pData;
+}
+
+bool InputReplay::StartRecording(const char *pszPath, bool fAutoStart, const Options &options)
+{
+    SDL_assert(!IsRecording() && !IsPlaying());
+    _pFile = SDL_RWFromFile(pszPath, "wb");
+    if (_pFile == nullptr)
+    {
+        printf("Failed to create replay %s! SDL Error: %s\n", pszPath, SDL_GetError());
+        return false;
+    }
+
+    Uint8 flags = static_cast<Uint8>((fAutoStart ? c_flagAutoStart : 0) | (options.fTruePathing ? c_flagTruePathing : 0));
+    Uint16 cchMazePath = static_cast<Uint16>(SDL_strlen(options.szMazePath));
+    Uint8 header[c_cbHeader] = { 'P', 'M', 'C', 'R', c_version, flags };
+    WriteUint(&header[6], options.cCrowdGhosts, 4);
+    WriteUint(&header[10], options.iMaze, 4);
+    WriteUint(&header[14], cchMazePath, 2);
+    SDL_RWwrite(_pFile, header, 1, sizeof(header));
+    SDL_RWwrite(_pFile, options.szMazePath, 1, cchMazePath);
+    _options = options;
+    _fAutoStart = fAutoStart;
+    _cTicks = 0;
+    _cInputs = 0;
+    _cRun = 0;
+    return true;
+}
+
+void InputReplay::WriteInput(Direction direction, bool fQuit)
+{
+    if (!IsRecording())
+    {
+        return;
+    }
+
+    Uint8 input = static_cast<Uint8>(static_cast<int>(direction) | (fQuit ? c_inputQuit : 0));
+    if ((_cRun != 0) && (input != _runInput))
+    {
+        WriteRun();
+    }
+    _runInput = input;
+    _cRun++;
+    _cInputs++;
+}
+
+// Input held for many ticks is the norm, so each run costs a couple of bytes
+void InputReplay::WriteRun()
+{
+    Uint8 buffer[6];
+    size_t cb = 0;
+    buffer[cb++] = _runInput;
+    Uint32 count = _cRun;
+    do
+    {
+        Uint8 byte = count & 0x7F;
+        count >>= 7;
+        buffer[cb++] = static_cast<Uint8>(byte | ((count != 0) ? 0x80 : 0));
+    } while (count != 0);
+
+    SDL_RWwrite(_pFile, buffer, 1, cb);
+    _cRun = 0;
+}
+
+void InputReplay::StopRecording(Uint64 checksum)
+{
+    if (!IsRecording())
+    {
+        return;
+    }
+
+    if (_cRun != 0)
+    {
+        WriteRun();
+    }
+
+    Uint8 trailer[c_cbTrailer];
+    trailer[0] = c_endOfInput;
+    WriteUint(&trailer[1], _cTicks, 4);
+    WriteUint(&trailer[5], static_cast<Uint32>(checksum), 4);
+    WriteUint(&trailer[9], static_cast<Uint32>(checksum >> 32), 4);
+    SDL_RWwrite(_pFile, trailer, 1, sizeof(trailer));
+    SDL_RWclose(_pFile);
+    _pFile = nullptr;
+    printf("Replay recorded: %u ticks, %u inputs\n", _cTicks, _cInputs);
+}
+
+bool InputReplay::StartPlayback(const char *pszPath)
+{
+    SDL_assert(!IsRecording() && !IsPlaying());
+    SDL_RWops *pFile = SDL_RWFromFile(pszPath, "rb");
+    if (pFile == nullptr)
+    {
+        printf("Failed to open replay %s! SDL Error: %s\n", pszPath, SDL_GetError());
+        return false;
+    }
+
+    // They're small, just read the whole thing
+    Sint64 cbFile = SDL_RWsize(pFile);
+    bool fResult = (cbFile >= static_cast<Sint64>(c_cbHeader + c_cbTrailer));
+    if (fResult)
+    {
+        _cbData = static_cast<size_t>(cbFile);
+        _pData = new Uint8[_cbData];
+        fResult = (SDL_RWread(pFile, _pData, 1, _cbData) == _cbData) &&
+            (SDL_memcmp(_pData, "PMCR", 4) == 0) && (_pData[4] == c_version) &&
+            (_pData[_cbData - c_cbTrailer] == c_endOfInput);
+    }
+
+    // The maze path has to fit between the header and the trailer, and in Options
+    size_t cchMazePath = fResult ? ReadUint(&_pData[14], 2) : 0;
+    fResult = fResult && (cchMazePath < c_cchMazePathMax) && (c_cbHeader + cchMazePath + c_cbTrailer <= _cbData);
+    SDL_RWclose(pFile);
+
+    if (!fResult)
+    {
+        printf("%s is not a replay file\n", pszPath);
+        delete[] _pData;
+        _pData = nullptr;
+        return false;
+    }
+
+    const Uint8 *pTrailer = _pData + _cbData - c_cbTrailer + 1;
+    _cTicksTotal = ReadUint(pTrailer, 4);
+    _checksum = ReadUint(pTrailer + 4, 4) | (static_cast<Uint64>(ReadUint(pTrailer + 8, 4)) << 32);
+
+    _fAutoStart = (_pData[5] & c_flagAutoStart) != 0;
+    SDL_memset(&_options, 0, sizeof(_options));
+    _options.fTruePathing = (_pData[5] & c_flagTruePathing) != 0;
+    _options.cCrowdGhosts = ReadUint(&_pData[6], 4);
+    _options.iMaze = ReadUint(&_pData[10], 4);
+    SDL_memcpy(_options.szMazePath, &_pData[c_cbHeader], cchMazePath);
+    _offset = c_cbHeader + cchMazePath;
+    _cPlayRemaining = 0;
+    _cTicks = 0;
+    _cInputs = 0;
+    printf("Playing replay %s: %u ticks\n", pszPath, _cTicksTotal);
+    return true;
+}
+
+bool InputReplay::ReadRun()
+{
+    const size_t endOfRuns = _cbData - c_cbTrailer;
+    if (_offset >= endOfRuns)
+    {
+        return false;
+    }
+
+    _playInput = _pData[_offset++];
+    _cPlayRemaining = 0;
+    for (int shift = 0; (_offset < endOfRuns) && (shift < 32); shift += 7)
+    {
+        Uint8 byte = _pData[_offset++];
+        _cPlayRemaining |= static_cast<Uint32>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            break;
+        }
+    }
+    return (_cPlayRemaining != 0);
+}
+
+bool InputReplay::ReadInput(Direction *pDirection)
+{
+    SDL_assert(IsPlaying());
+    if ((_cPlayRemaining == 0) && !ReadRun())
+    {
+        printf("Replay ran out of input after %u ticks\n", _cTicks);
+        *pDirection = Direction::None;
+        return true;
+    }
+
+    _cPlayRemaining--;
+    _cInputs++;
+    *pDirection = static_cast<Direction>(_playInput & c_inputDirectionMask);
+    return (_playInput & c_inputQuit) != 0;
+}
+
+bool InputReplay::FinishPlayback(Uint64 checksum)
+{
+    bool fMatch = (checksum == _checksum) && (_cTicks == _cTicksTotal);
+    printf("Replay finished after %u ticks, %u inputs: %s\n", _cTicks, _cInputs, fMatch ? "state matches the recording" : "STATE DIFFERS from the recording");
+    StopPlayback();
+    return fMatch;
+}
+
+void InputReplay::StopPlayback()
+{
+    delete[] _pData;
+    _pData = nullptr;
+}
@@ -1,16 +1,199 @@
 // main.cpp : Defines the entry point for the console application.
 //
 #include "include/gameharness.h"
+#include "include/rolloutfarm.h"
 
 using namespace XplatGameTutorial::PacManClone;
 
-int main(int /*argc*/, char* /*argv*/[])
+// Decode the PNGs once, offline, so the game can map them in ready to draw
+static int BakeAssets(const char *pszPath)
+{
+    bool fResult = InitializeSDLImage() && AssetPack::Bake(pszPath);
+    IMG_Quit();
+    return fResult ? 0 : 1;
+}
+
+// The built in maze as a one maze pack, somewhere to start a level pack from
+static int BakeMaze(const char *pszPath)
+{
+    return MazePack::Write(pszPath, &Constants::ClassicMaze, 1) ? 0 : 1;
+}
+
+// Play cGames wandering games across the farm and print how it went.  They're played on maze
+// iMaze of the pack at pszMaze if there is one, the classic maze otherwise
+static int RunRollouts(Uint32 cGames, Uint32 cWorkers, bool fTruePathing, const char *pszMaze, Uint32 iMaze, bool fVerifyMaze)
+{
+    static const Uint32 c_cMaxTicks = 60 * 60 * 5;     // Five minutes of play at 60Hz
+
+    MazePack mazePack;
+    MazeLayout layout = Constants::ClassicMaze;
+    if ((pszMaze != nullptr) && (!mazePack.Open(pszMaze) || !mazePack.GetLayout(iMaze, &layout, fVerifyMaze)))
+    {
+        return 1;
+    }
+
+    RolloutFarm farm;
+    if (!farm.Initialize(cWorkers, fTruePathing, layout))
+    {
+        return 1;
+    }
+
+    RolloutFarm::Result *pResults = new RolloutFarm::Result[cGames];
+    bool fResult = farm.Run(cGames, c_cMaxTicks, nullptr, nullptr, pResults);
+
+    Uint64 totalScore = 0;
+    Uint32 cCleared = 0;
+    Uint32 cCaught = 0;
+    for (Uint32 i = 0; i < cGames; i++)
+    {
+        totalScore += pResults[i].score;
+        cCleared += pResults[i].fCleared ? 1 : 0;
+        cCaught += pResults[i].fCaught ? 1 : 0;
+    }
+    delete[] pResults;
+
+    const RolloutFarm::Stats &stats = farm.LastStats();
+    double ticksPerSecond = (stats.msElapsed != 0) ? (stats.cTicks * 1000.0) / stats.msElapsed : 0.0;
+    printf("%u games on %u threads: %llu ticks in %u ms (%.2f M ticks/s), %u steals\n",
+        cGames, stats.cWorkers, static_cast<unsigned long long>(stats.cTicks), stats.msElapsed,
+        ticksPerSecond / 1000000.0, stats.cSteals);
+    printf("average score %.1f, %u cleared, %u caught\n",
+        (cGames != 0) ? static_cast<double>(totalScore) / cGames : 0.0, cCleared, cCaught);
+    return fResult ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
 {
     GameHarness gameHarness;
 
-    if (gameHarness.Initialize() == SDL_TRUE)
+    // "--headless [frames]" runs the simulation with no window, renderer or frame pacing,
+    // optionally exiting after the given number of frames
+    // "--true-pathing" has the ghosts follow real shortest paths instead of the greedy targeting
+    // "--ghosts count" adds that many more ghosts (party mode)
+    // "--profile" times each phase of the frame and writes the results to profile.csv on exit
+    // "--record file" saves the game's input, "--replay file" plays it back (uncapped with --headless)
+    // "--rollouts games" plays that many games across every core with no window (on the --maze one
+    // if given) and exits,
+    // "--threads count" limits how many threads it uses
+    // "--bake-assets [file]" writes the textures out as an asset pack (grfx/assets.pmca by default)
+    // for the game to load instead of the PNGs, and exits
+    // "--maze file [index]" plays a maze from a maze pack (the first one by default),
+    // "--verify-maze" checks every tile of it as it's loaded
+    // "--bake-maze file" writes the built in maze out as a maze pack and exits
+    bool fHeadless = false;
+    bool fTruePathing = false;
+    bool fVerifyMaze = false;
+    Uint32 cRollouts = 0;
+    Uint32 cThreads = 0;
+    Uint32 cMaxFrames = 0;
+    const char *pszRecord = nullptr;
+    const char *pszReplay = nullptr;
+    const char *pszBake = nullptr;
+    const char *pszBakeMaze = nullptr;
+    const char *pszMaze = nullptr;
+    Uint32 iMaze = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (SDL_strcmp(argv[i], "--headless") == 0)
+        {
+            fHeadless = true;
+            if ((i + 1 < argc) && (argv[i + 1][0] != '-'))
+            {
+                cMaxFrames = static_cast<Uint32>(SDL_atoi(argv[++i]));
+            }
+        }
+        else if (SDL_strcmp(argv[i], "--true-pathing") == 0)
+        {
+            gameHarness.EnableTruePathing(true);
+            fTruePathing = true;
+        }
+        else if (SDL_strcmp(argv[i], "--profile") == 0)
+        {
+            gameHarness.EnableProfiling(true);
+        }
+        else if ((SDL_strcmp(argv[i], "--record") == 0) && (i + 1 < argc))
+        {
+            pszRecord = argv[++i];
+        }
+        else if ((SDL_strcmp(argv[i], "--replay") == 0) && (i + 1 < argc))
+        {
+            pszReplay = argv[++i];
+        }
+        else if ((SDL_strcmp(argv[i], "--ghosts") == 0) && (i + 1 < argc))
+        {
+            gameHarness.EnableCrowd(static_cast<Uint32>(SDL_atoi(argv[++i])));
+        }
+        else if ((SDL_strcmp(argv[i], "--rollouts") == 0) && (i + 1 < argc))
+        {
+            cRollouts = static_cast<Uint32>(SDL_atoi(argv[++i]));
+        }
+        else if ((SDL_strcmp(argv[i], "--threads") == 0) && (i + 1 < argc))
+        {
+            cThreads = static_cast<Uint32>(SDL_atoi(argv[++i]));
+        }
+        else if (SDL_strcmp(argv[i], "--bake-assets") == 0)
+        {
+            pszBake = Constants::AssetPackFile;
+            if ((i + 1 < argc) && (argv[i + 1][0] != '-'))
+            {
+                pszBake = argv[++i];
+            }
+        }
+        else if ((SDL_strcmp(argv[i], "--maze") == 0) && (i + 1 < argc))
+        {
+            pszMaze = argv[++i];
+            if ((i + 1 < argc) && (argv[i + 1][0] != '-'))
+            {
+                iMaze = static_cast<Uint32>(SDL_atoi(argv[++i]));
+            }
+        }
+        else if (SDL_strcmp(argv[i], "--verify-maze") == 0)
+        {
+            gameHarness.EnableMazeVerification(true);
+            fVerifyMaze = true;
+        }
+        else if ((SDL_strcmp(argv[i], "--bake-maze") == 0) && (i + 1 < argc))
+        {
+            pszBakeMaze = argv[++i];
+        }
+    }
+
+    if (pszBake != nullptr)
+    {
+        return BakeAssets(pszBake);
+    }
+
+    if (pszBakeMaze != nullptr)
+    {
+        return BakeMaze(pszBakeMaze);
+    }
+
+    if (cRollouts != 0)
+    {
+        return RunRollouts(cRollouts, cThreads, fTruePathing, pszMaze, iMaze, fVerifyMaze);
+    }
+
+    if ((pszMaze != nullptr) && !gameHarness.LoadMaze(pszMaze, iMaze))
+    {
+        return 1;
+    }
+
+    if (gameHarness.Initialize(fHeadless, cMaxFrames) == SDL_TRUE)
     { 
-        gameHarness.Run();
+        bool fReady = true;
+        if (pszReplay != nullptr)
+        {
+            fReady = gameHarness.PlayReplay(pszReplay);
+        }
+        else if (pszRecord != nullptr)
+        {
+            fReady = gameHarness.RecordReplay(pszRecord);
+        }
+
+        if (fReady)
+        {
+            gameHarness.Run();
+        }
     }
-    return 0;
+    return gameHarness.ReplayFailed() ? 1 : 0;
 }
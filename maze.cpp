@@ -0,0 +1,127 @@
+#include "include/maze.h"
+#include "include/sprite.h"
+
+using namespace XplatGameTutorial::PacManClone;
+
+bool Maze::Initialize(SDL_Rect textureRect, SDL_Rect tileRect, SDL_Texture *pTexture)
+{
+    SDL_assert(_pPellets == nullptr);
+    size_t cTiles = static_cast<size_t>(_layout.rows) * _layout.cols;
+
+    // Nothing writes to the attributes or the starting pellets, the pellets being eaten live in
+    // the bitboards.  The pellets and power pellets are side by side so they count in one go, and
+    // they're the only tiles that ever change so the map gets them as its changeable tiles
+    _pTileAttributes = _layout.pAttributes;
+    _cPelletWords = PelletBoard::WordsFor(cTiles);
+    _pStartPellets = _layout.pPellets;
+    _pStartPowerPellets = _layout.pPowerPellets;
+    _pPellets = new Uint64[2 * _cPelletWords];
+    _pPowerPellets = _pPellets + _cPelletWords;
+    SDL_memcpy(_pPellets, _pStartPellets, _cPelletWords * sizeof(Uint64));
+    SDL_memcpy(_pPowerPellets, _pStartPowerPellets, _cPelletWords * sizeof(Uint64));
+    _cPelletsRemaining = PelletBoard::Count(_pPellets, 2 * _cPelletWords);
+
+    return TiledMap::Initialize(textureRect, tileRect, pTexture, _layout.pTiles, cTiles, TileStore::c_cbDefaultBudget, _pPellets, 2);
+}
+
+// The tiles drawn always match the bits, so only the tiles whose pellet came or went need
+// redrawing (and marking dirty for the render cache)
+void Maze::RestorePellets(const Uint64 *pPellets, const Uint64 *pPowerPellets)
+{
+    for (size_t word = 0; word < _cPelletWords; word++)
+    {
+        Uint64 changed = (_pPellets[word] ^ pPellets[word]) | (_pPowerPellets[word] ^ pPowerPellets[word]);
+        while (changed != 0)
+        {
+            Uint32 bit = PelletBoard::LowestBit(changed);
+            changed &= changed - 1;
+
+            Uint16 index = c_emptyTile;
+            if (((pPellets[word] >> bit) & 1) != 0)
+            {
+                index = c_pelletTile;
+            }
+            else if (((pPowerPellets[word] >> bit) & 1) != 0)
+            {
+                index = c_powerPelletTile;
+            }
+
+            size_t tile = (word * 64) + bit;
+            SetTileIndexAt(static_cast<Uint16>(tile / _cCols), static_cast<Uint16>(tile % _cCols), index);
+        }
+    }
+
+    SDL_memcpy(_pPellets, pPellets, _cPelletWords * sizeof(Uint64));
+    SDL_memcpy(_pPowerPellets, pPowerPellets, _cPelletWords * sizeof(Uint64));
+    _cPelletsRemaining = PelletBoard::Count(_pPellets, 2 * _cPelletWords);
+}
+
+void Maze::BuildPathTable()
+{
+    if ((_pPathTable != nullptr) || (_pPathHierarchy != nullptr))
+    {
+        return;
+    }
+
+    // The table only needs the exits of each tile
+    Uint32 cTiles = static_cast<Uint32>(_cRows) * _cCols;
+    Uint8 *pExitMasks = new Uint8[cTiles];
+    for (Uint32 tile = 0; tile < cTiles; tile++)
+    {
+        pExitMasks[tile] = static_cast<Uint8>(_pTileAttributes[tile] & MazeAttributes::Exits);
+    }
+
+    // The table is 1.25 bytes per pair of walkable tiles, and every maze (so every rollout worker
+    // and batched game) builds its own.  The classic maze is about 110KB, one at the limit as open
+    // as that is about 630KB, and 5MB if every one of its tiles were walkable
+    if (cTiles <= c_maxPathTableTiles)
+    {
+        // Without one the ghosts just keep to the straight line heuristic
+        _pPathTable = new PathTable();
+        if (!_pPathTable->Build(_cRows, _cCols, pExitMasks, _layout.playerStart.row, _layout.playerStart.col))
+        {
+            delete _pPathTable;
+            _pPathTable = nullptr;
+        }
+    }
+    else
+    {
+        _pPathHierarchy = new PathHierarchy();
+        if (!_pPathHierarchy->Build(_cRows, _cCols, pExitMasks, _layout.playerStart.row, _layout.playerStart.col))
+        {
+            delete _pPathHierarchy;
+            _pPathHierarchy = nullptr;
+        }
+    }
+    delete[] pExitMasks;
+}
+
+SDL_bool Maze::IsSpritePastCenter(Uint16 row, Uint16 col, Sprite* pSprite)
+{
+    SDL_bool result = SDL_FALSE;
+
+    // This returns the center pixel which is useful here
+    SDL_Point centerPoint = GetTileCoordinates(row, col);
+
+    // Now based on the direction, are we ahead of or behind that center pixel?  Compared in fixed
+    // point so part way into the center pixel isn't past it
+    Fixed xCenter = ToFixed(centerPoint.x);
+    Fixed yCenter = ToFixed(centerPoint.y);
+    if (pSprite->DX() < 0)
+    {
+        result = (pSprite->FixedX() <= xCenter) ? SDL_TRUE : SDL_FALSE;
+    }
+    else if (pSprite->DX() > 0)
+    {
+        result = (pSprite->FixedX() > xCenter) ? SDL_TRUE : SDL_FALSE;
+    }
+    else if (pSprite->DY() < 0)
+    {
+        result = (pSprite->FixedY() <= yCenter) ? SDL_TRUE : SDL_FALSE;
+    }
+    else if (pSprite->DY() > 0)
+    {
+        result = (pSprite->FixedY() > yCenter) ? SDL_TRUE : SDL_FALSE;
+    }
+    return result;
+}
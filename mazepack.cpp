@@ -0,0 +1,291 @@
+#include "include/mazepack.h"
+#include "include/mazeattributes.h"
+#include "include/pelletboard.h"
+
+using namespace XplatGameTutorial::PacManClone;
+
+namespace
+{
+    size_t AlignUp(size_t cb, size_t cbAlign)
+    {
+        return (cb + cbAlign - 1) & ~(cbAlign - 1);
+    }
+
+    // Record, warps and the three layers, the pellet words start on the next 8 byte boundary
+    size_t PelletsOffset(Uint16 rows, Uint16 cols, Uint16 cWarps)
+    {
+        size_t cTiles = static_cast<size_t>(rows) * cols;
+        return AlignUp(sizeof(MazePack::Record) + (cWarps * sizeof(MazeLayout::WarpPair)) + (3 * cTiles * sizeof(Uint16)), sizeof(Uint64));
+    }
+
+    size_t MazeSize(Uint16 rows, Uint16 cols, Uint16 cWarps)
+    {
+        size_t cTiles = static_cast<size_t>(rows) * cols;
+        return PelletsOffset(rows, cols, cWarps) + (2 * PelletBoard::WordsFor(cTiles) * sizeof(Uint64));
+    }
+}
+
+bool MazePack::Open(const char *pszPath)
+{
+    SDL_assert(!IsOpen());
+    if (!_file.Open(pszPath))
+    {
+        printf("MazePack::Open() : can't open %s\n", pszPath);
+        return false;
+    }
+
+    const Header *pHeader = reinterpret_cast<const Header *>(_file.Data());
+    if ((_file.Size() < sizeof(Header)) || (SDL_memcmp(pHeader->magic, "PMCM", 4) != 0) || (pHeader->version != c_version) ||
+        (pHeader->cMazes > (_file.Size() - sizeof(Header)) / sizeof(Uint64)))
+    {
+        printf("MazePack::Open() : %s is not a maze pack\n", pszPath);
+        _file.Close();
+        return false;
+    }
+    _pHeader = pHeader;
+    return true;
+}
+
+void MazePack::Close()
+{
+    _pHeader = nullptr;
+    _file.Close();
+}
+
+bool MazePack::GetLayout(Uint32 iMaze, MazeLayout *pLayout, bool fVerify)
+{
+    if (iMaze >= Count())
+    {
+        printf("MazePack::GetLayout() : no maze %u, there are %u\n", iMaze, Count());
+        return false;
+    }
+
+    const Uint64 *pOffsets = reinterpret_cast<const Uint64 *>(_pHeader + 1);
+    Uint64 offset = pOffsets[iMaze];
+    if ((offset % sizeof(Uint64) != 0) || (_file.Size() < sizeof(Record)) || (offset > _file.Size() - sizeof(Record)))
+    {
+        printf("MazePack::GetLayout() : maze %u is outside the file\n", iMaze);
+        return false;
+    }
+
+    const Record &record = *reinterpret_cast<const Record *>(_file.Data() + offset);
+    if (MazeSize(record.rows, record.cols, record.cWarps) > _file.Size() - offset)
+    {
+        printf("MazePack::GetLayout() : maze %u is outside the file\n", iMaze);
+        return false;
+    }
+
+    const MazeLayout::WarpPair *pWarps = reinterpret_cast<const MazeLayout::WarpPair *>(&record + 1);
+    const Uint16 *pTiles = reinterpret_cast<const Uint16 *>(pWarps + record.cWarps);
+    const Uint64 *pPellets = reinterpret_cast<const Uint64 *>(reinterpret_cast<const Uint8 *>(&record) +
+        PelletsOffset(record.rows, record.cols, record.cWarps));
+    size_t cTiles = static_cast<size_t>(record.rows) * record.cols;
+    MazeLayout layout =
+    {
+        record.rows,
+        record.cols,
+        pTiles,
+        pTiles + cTiles,
+        pTiles + (2 * cTiles),
+        record.cPellets,
+        pPellets,
+        pPellets + PelletBoard::WordsFor(cTiles),
+        record.playerStart,
+        { record.ghostStarts[0], record.ghostStarts[1], record.ghostStarts[2], record.ghostStarts[3] },
+        { record.scatterTargets[0], record.scatterTargets[1], record.scatterTargets[2], record.scatterTargets[3] },
+        record.pen,
+        record.penExit,
+        pWarps,
+        record.cWarps
+    };
+    if (!IsPlayable(layout) || (fVerify && !HasPlayableTiles(layout)))
+    {
+        printf("MazePack::GetLayout() : maze %u can't be played\n", iMaze);
+        return false;
+    }
+    if (fVerify && !HasAttributes(layout))
+    {
+        printf("MazePack::GetLayout() : maze %u has the wrong attributes\n", iMaze);
+        return false;
+    }
+
+    *pLayout = layout;
+    return true;
+}
+
+bool MazePack::Write(const char *pszPath, const MazeLayout *pLayouts, Uint32 cLayouts)
+{
+    for (Uint32 i = 0; i < cLayouts; i++)
+    {
+        if (!IsPlayable(pLayouts[i]) || !HasPlayableTiles(pLayouts[i]))
+        {
+            printf("MazePack::Write() : maze %u can't be played\n", i);
+            return false;
+        }
+    }
+
+    SDL_RWops *pFile = SDL_RWFromFile(pszPath, "wb");
+    if (pFile == nullptr)
+    {
+        printf("SDL_RWFromFile() failed, error = %s\n", SDL_GetError());
+        return false;
+    }
+
+    Header header = { { 'P', 'M', 'C', 'M' }, c_version, cLayouts, 0 };
+    Uint64 *pOffsets = new Uint64[cLayouts];
+    size_t offset = AlignUp(sizeof(Header) + (cLayouts * sizeof(Uint64)), sizeof(Uint64));
+    size_t cbTotal = offset;
+    for (Uint32 i = 0; i < cLayouts; i++)
+    {
+        const MazeLayout &layout = pLayouts[i];
+        pOffsets[i] = offset;
+        cbTotal = offset + MazeSize(layout.rows, layout.cols, layout.cWarps);
+        offset = AlignUp(cbTotal, sizeof(Uint64));
+    }
+
+    static const Uint8 c_padding[sizeof(Uint64)] = { };
+    size_t cbWritten = SDL_RWwrite(pFile, &header, 1, sizeof(header));
+    cbWritten += SDL_RWwrite(pFile, pOffsets, 1, cLayouts * sizeof(Uint64));
+    for (Uint32 i = 0; i < cLayouts; i++)
+    {
+        const MazeLayout &layout = pLayouts[i];
+        size_t cTiles = static_cast<size_t>(layout.rows) * layout.cols;
+        Uint16 *pAttributes = new Uint16[cTiles];
+        size_t cPelletWords = PelletBoard::WordsFor(cTiles);
+        Uint64 *pPellets = new Uint64[2 * cPelletWords] { };
+
+        Record record;
+        SDL_memset(&record, 0, sizeof(record));
+        record.rows = layout.rows;
+        record.cols = layout.cols;
+        record.cPellets = MazeAttributes::BuildTable(layout, pAttributes);
+        for (size_t tile = 0; tile < cTiles; tile++)
+        {
+            if ((pAttributes[tile] & MazeAttributes::Pellet) != 0)
+            {
+                PelletBoard::Set(pPellets, tile);
+            }
+            if ((pAttributes[tile] & MazeAttributes::PowerPellet) != 0)
+            {
+                PelletBoard::Set(pPellets + cPelletWords, tile);
+            }
+        }
+        record.cWarps = layout.cWarps;
+        record.playerStart = layout.playerStart;
+        SDL_memcpy(record.ghostStarts, layout.ghostStarts, sizeof(record.ghostStarts));
+        SDL_memcpy(record.scatterTargets, layout.scatterTargets, sizeof(record.scatterTargets));
+        record.pen = layout.pen;
+        record.penExit = layout.penExit;
+
+        cbWritten += SDL_RWwrite(pFile, c_padding, 1, static_cast<size_t>(pOffsets[i]) - cbWritten);
+        cbWritten += SDL_RWwrite(pFile, &record, 1, sizeof(record));
+        cbWritten += SDL_RWwrite(pFile, layout.pWarps, 1, layout.cWarps * sizeof(MazeLayout::WarpPair));
+        cbWritten += SDL_RWwrite(pFile, layout.pTiles, 1, cTiles * sizeof(Uint16));
+        cbWritten += SDL_RWwrite(pFile, layout.pCollision, 1, cTiles * sizeof(Uint16));
+        cbWritten += SDL_RWwrite(pFile, pAttributes, 1, cTiles * sizeof(Uint16));
+        size_t cbPadding = static_cast<size_t>(pOffsets[i]) + PelletsOffset(layout.rows, layout.cols, layout.cWarps) - cbWritten;
+        cbWritten += SDL_RWwrite(pFile, c_padding, 1, cbPadding);
+        cbWritten += SDL_RWwrite(pFile, pPellets, 1, 2 * cPelletWords * sizeof(Uint64));
+        delete[] pPellets;
+        delete[] pAttributes;
+    }
+
+    bool fResult = (cbWritten == cbTotal);
+    if (SDL_RWclose(pFile) != 0)
+    {
+        fResult = false;
+    }
+    delete[] pOffsets;
+    printf("Wrote %u mazes into %s (%u bytes)\n", cLayouts, pszPath, static_cast<unsigned int>(cbWritten));
+    return fResult;
+}
+
+bool MazePack::IsPlayable(const MazeLayout &layout)
+{
+    auto inside = [&layout](const MazeLayout::Cell &cell)
+    {
+        return (cell.row < layout.rows) && (cell.col < layout.cols);
+    };
+
+    bool fResult = (layout.rows != 0) && (layout.cols != 0) &&
+        (layout.rows <= Constants::MaxMazeSide) && (layout.cols <= Constants::MaxMazeSide) &&
+        (layout.pTiles != nullptr) && (layout.pCollision != nullptr) &&
+        inside(layout.playerStart) && (layout.playerStart.col + 1 < layout.cols);
+
+    for (size_t i = 0; fResult && (i < MazeLayout::c_cGhosts); i++)
+    {
+        fResult = inside(layout.ghostStarts[i]) && inside(layout.scatterTargets[i]);
+    }
+
+    // Released ghosts go straight up from the bottom of the pen to its exit
+    const MazeLayout::Region &pen = layout.pen;
+    fResult = fResult && (pen.top <= pen.bottom) && (pen.left <= pen.right) && inside({ pen.bottom, pen.right }) &&
+        inside(layout.penExit) && (layout.penExit.row < pen.top) &&
+        (layout.penExit.col >= pen.left) && (layout.penExit.col <= pen.right);
+
+    for (Uint16 i = 0; fResult && (i < layout.cWarps); i++)
+    {
+        const MazeLayout::WarpPair &warp = layout.pWarps[i];
+        fResult = (warp.from.row == warp.to.row) && (warp.from.row < layout.rows) &&
+            (warp.from.col == 0) && (warp.to.col == layout.cols - 1);
+    }
+    return fResult;
+}
+
+bool MazePack::HasPlayableTiles(const MazeLayout &layout)
+{
+    bool fResult = true;
+
+    // Every tile has to be on the tiles texture, and the only way off the map is through the ends
+    // of a warp tunnel (the sprites can't leave it any other way)
+    for (Uint16 row = 0; fResult && (row < layout.rows); row++)
+    {
+        bool fEdgeRow = (row == 0) || (row == layout.rows - 1);
+        bool fWarpRow = layout.IsWarpRow(row);
+        for (Uint16 col = 0; fResult && (col < layout.cols); col++)
+        {
+            size_t tile = (static_cast<size_t>(row) * layout.cols) + col;
+            bool fEdgeCol = (col == 0) || (col == layout.cols - 1);
+            Uint16 collision = layout.pCollision[tile];
+            fResult = (layout.pTiles[tile] < Constants::TileTextureCount) && (collision <= 1) &&
+                ((collision == 1) || !(fEdgeRow || fEdgeCol) || (fWarpRow && !fEdgeRow));
+        }
+    }
+    return fResult;
+}
+
+bool MazePack::HasAttributes(const MazeLayout &layout)
+{
+    Uint32 cPellets = 0;
+    for (int row = 0; row < layout.rows; row++)
+    {
+        bool fWarpRow = layout.IsWarpRow(static_cast<Uint16>(row));
+        for (int col = 0; col < layout.cols; col++)
+        {
+            Uint16 attributes = MazeAttributes::ForTile(layout.pCollision, layout.pTiles, layout.rows, layout.cols, row, col, layout.pen, fWarpRow);
+            if (layout.pAttributes[(static_cast<size_t>(row) * layout.cols) + col] != attributes)
+            {
+                return false;
+            }
+            cPellets += ((attributes & (MazeAttributes::Pellet | MazeAttributes::PowerPellet)) != 0) ? 1 : 0;
+        }
+    }
+    if (cPellets != layout.cPellets)
+    {
+        return false;
+    }
+
+    // The starting pellets are the tiles with a pellet attribute, and only those
+    size_t cTiles = static_cast<size_t>(layout.rows) * layout.cols;
+    for (size_t tile = 0; tile < cTiles; tile++)
+    {
+        Uint16 attributes = layout.pAttributes[tile];
+        if ((PelletBoard::Test(layout.pPellets, tile) != ((attributes & MazeAttributes::Pellet) != 0)) ||
+            (PelletBoard::Test(layout.pPowerPellets, tile) != ((attributes & MazeAttributes::PowerPellet) != 0)))
+        {
+            return false;
+        }
+    }
+    size_t cPelletWords = PelletBoard::WordsFor(cTiles);
+    return (PelletBoard::Count(layout.pPellets, cPelletWords) + PelletBoard::Count(layout.pPowerPellets, cPelletWords)) == cPellets;
+}
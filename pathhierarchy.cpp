@@ -0,0 +1,642 @@
+#include "include/pathhierarchy.h"
+
+using namespace XplatGameTutorial::PacManClone;
+
+PathHierarchy::PathHierarchy() :
+    _cRows(0),
+    _cCols(0),
+    _cClusterCols(0),
+    _cClusters(0),
+    _pExits(nullptr),
+    _pNearestTiles(nullptr),
+    _cNodes(0),
+    _pNodeTiles(nullptr),
+    _pClusterNodes(nullptr),
+    _pEdgeStart(nullptr),
+    _pEdges(nullptr),
+    _cEdges(0),
+    _cQueries(0)
+{
+    SDL_memset(_searches, 0, sizeof(_searches));
+}
+
+PathHierarchy::~PathHierarchy()
+{
+    for (size_t i = 0; i < c_cSearches; i++)
+    {
+        delete[] _searches[i].pDistance;
+        delete[] _searches[i].pSettled;
+        delete[] _searches[i].pHeapIndex;
+        delete[] _searches[i].pHeap;
+    }
+    delete[] _pExits;
+    delete[] _pNearestTiles;
+    delete[] _pNodeTiles;
+    delete[] _pClusterNodes;
+    delete[] _pEdgeStart;
+    delete[] _pEdges;
+}
+
+// Tile index of the neighbour in the given direction, wrapping around the edges like the warp tunnel
+Uint32 PathHierarchy::NeighbourTile(Uint32 tile, Direction direction)
+{
+    Uint32 row = tile / _cCols;
+    Uint32 col = tile % _cCols;
+    switch (direction)
+    {
+    case Direction::Up:
+        row = (row == 0) ? _cRows - 1 : row - 1;
+        break;
+    case Direction::Down:
+        row = (row == _cRows - 1u) ? 0 : row + 1;
+        break;
+    case Direction::Left:
+        col = (col == 0) ? _cCols - 1 : col - 1;
+        break;
+    case Direction::Right:
+        col = (col == _cCols - 1u) ? 0 : col + 1;
+        break;
+    case Direction::None:
+        break;
+    }
+    return (row * _cCols) + col;
+}
+
+bool PathHierarchy::Build(Uint16 rows, Uint16 cols, const Uint8 *pExitMasks, Uint16 startRow, Uint16 startCol)
+{
+    SDL_assert(_pExits == nullptr);
+    if ((startRow >= rows) || (startCol >= cols) || (pExitMasks[(static_cast<Uint32>(startRow) * cols) + startCol] == 0))
+    {
+        printf("PathHierarchy::Build() : [%u][%u] isn't in the playing area\n", startRow, startCol);
+        return false;
+    }
+
+    _cRows = rows;
+    _cCols = cols;
+    _cClusterCols = (cols + c_clusterMask) >> c_clusterShift;
+    _cClusters = ((rows + c_clusterMask) >> c_clusterShift) * _cClusterCols;
+    Uint32 cTiles = static_cast<Uint32>(rows) * cols;
+
+    // Flood out from the start tile to find the playing area, anything it doesn't reach (the ghost
+    // pen) is left with no exits
+    _pExits = new Uint8[cTiles] { };
+    Uint32 *pQueue = new Uint32[cTiles];
+    Uint32 startTile = (static_cast<Uint32>(startRow) * cols) + startCol;
+    Uint32 head = 0;
+    Uint32 tail = 0;
+    _pExits[startTile] = pExitMasks[startTile];
+    pQueue[tail++] = startTile;
+    while (head < tail)
+    {
+        Uint32 tile = pQueue[head++];
+        for (int index = 0; index < 4; index++)
+        {
+            if ((pExitMasks[tile] & (1 << index)) != 0)
+            {
+                Uint32 nextTile = NeighbourTile(tile, static_cast<Direction>(index));
+                if ((_pExits[nextTile] == 0) && (pExitMasks[nextTile] != 0))
+                {
+                    _pExits[nextTile] = pExitMasks[nextTile];
+                    pQueue[tail++] = nextTile;
+                }
+            }
+        }
+    }
+    delete[] pQueue;
+
+    BuildNearestTiles();
+
+    // Counted first, then filled in
+    Uint32 cCrossings = FindCrossings(nullptr);
+    Crossing *pCrossings = new Crossing[SDL_max(cCrossings, 1u)];
+    FindCrossings(pCrossings);
+
+    Uint32 *pTileNodes = new Uint32[cTiles];
+    SDL_memset(pTileNodes, 0xFF, cTiles * sizeof(Uint32));
+    BuildEdges(pCrossings, cCrossings, pTileNodes);
+    delete[] pTileNodes;
+    delete[] pCrossings;
+
+    // A node is only ever on the heap once (a shorter way moves it up), so it never needs more room
+    // than there are nodes
+    for (size_t i = 0; i < c_cSearches; i++)
+    {
+        Search &search = _searches[i];
+        search.goalTile = c_invalid;
+        search.pDistance = new Uint32[SDL_max(_cNodes, 1u)];
+        search.pSettled = new Uint8[SDL_max(_cNodes, 1u)];
+        search.pHeapIndex = new Uint32[SDL_max(_cNodes, 1u)];
+        search.pHeap = new Uint32[SDL_max(_cNodes, 1u)];
+    }
+    return true;
+}
+
+// Every tile gets the closest playing area tile by a plain grid flood (walls ignored) out from all
+// of them at once
+void PathHierarchy::BuildNearestTiles()
+{
+    Uint32 cTiles = static_cast<Uint32>(_cRows) * _cCols;
+    _pNearestTiles = new Uint32[cTiles];
+    SDL_memset(_pNearestTiles, 0xFF, cTiles * sizeof(Uint32));
+
+    Uint32 *pQueue = new Uint32[cTiles];
+    Uint32 head = 0;
+    Uint32 tail = 0;
+    for (Uint32 tile = 0; tile < cTiles; tile++)
+    {
+        if (_pExits[tile] != 0)
+        {
+            _pNearestTiles[tile] = tile;
+            pQueue[tail++] = tile;
+        }
+    }
+
+    while (head < tail)
+    {
+        Uint32 tile = pQueue[head++];
+        Uint32 row = tile / _cCols;
+        Uint32 col = tile % _cCols;
+        Uint32 neighbours[4] = { c_invalid, c_invalid, c_invalid, c_invalid };
+        if (row > 0) neighbours[0] = tile - _cCols;
+        if (row < _cRows - 1u) neighbours[1] = tile + _cCols;
+        if (col > 0) neighbours[2] = tile - 1;
+        if (col < _cCols - 1u) neighbours[3] = tile + 1;
+
+        for (size_t index = 0; index < SDL_arraysize(neighbours); index++)
+        {
+            if ((neighbours[index] != c_invalid) && (_pNearestTiles[neighbours[index]] == c_invalid))
+            {
+                _pNearestTiles[neighbours[index]] = _pNearestTiles[tile];
+                pQueue[tail++] = neighbours[index];
+            }
+        }
+    }
+    delete[] pQueue;
+}
+
+// Walk the right and bottom edge of every cluster (the last ones wrapping round to the first) for
+// runs of tiles that can move across it.  Null pCrossings just counts them
+Uint32 PathHierarchy::FindCrossings(Crossing *pCrossings)
+{
+    Uint32 cCrossings = 0;
+    Direction directions[] = { Direction::Right, Direction::Down };
+    for (size_t index = 0; index < SDL_arraysize(directions); index++)
+    {
+        Direction direction = directions[index];
+        bool fRight = (direction == Direction::Right);
+        Uint32 cBorders = fRight ? _cClusterCols : ((_cRows + c_clusterMask) >> c_clusterShift);
+        Uint32 cAlong = fRight ? _cRows : _cCols;
+        Uint32 cAcross = fRight ? _cCols : _cRows;
+        for (Uint32 border = 0; border < cBorders; border++)
+        {
+            Uint32 across = SDL_min(((border + 1) << c_clusterShift) - 1, cAcross - 1);
+            for (Uint32 start = 0; start < cAlong; start += c_clusterSide)
+            {
+                Uint32 end = SDL_min(start + c_clusterSide, cAlong);
+                Uint32 cRun = 0;
+                for (Uint32 along = start; along <= end; along++)
+                {
+                    bool fCrossing = false;
+                    if (along < end)
+                    {
+                        Uint32 tile = fRight ? (along * _cCols) + across : (across * _cCols) + along;
+                        fCrossing = ((_pExits[tile] & (1 << static_cast<int>(direction))) != 0) &&
+                            (ClusterOf(NeighbourTile(tile, direction)) != ClusterOf(tile));
+                    }
+
+                    if (fCrossing)
+                    {
+                        cRun++;
+                    }
+                    else if (cRun != 0)
+                    {
+                        Uint32 row = fRight ? along - cRun : across;
+                        Uint32 col = fRight ? across : along - cRun;
+                        cCrossings = AddCrossings(pCrossings, cCrossings, row, col, direction, cRun);
+                        cRun = 0;
+                    }
+                }
+            }
+        }
+    }
+    return cCrossings;
+}
+
+// A narrow run gets a crossing in the middle, a wide one at both ends
+Uint32 PathHierarchy::AddCrossings(Crossing *pCrossings, Uint32 cCrossings, Uint32 fromRow, Uint32 fromCol, Direction direction, Uint32 cRun)
+{
+    Uint32 offsets[2] = { cRun / 2, 0 };
+    Uint32 cOffsets = 1;
+    if (cRun >= c_longCrossing)
+    {
+        offsets[0] = 0;
+        offsets[1] = cRun - 1;
+        cOffsets = 2;
+    }
+
+    for (Uint32 i = 0; i < cOffsets; i++)
+    {
+        Uint32 row = fromRow + ((direction == Direction::Right) ? offsets[i] : 0);
+        Uint32 col = fromCol + ((direction == Direction::Down) ? offsets[i] : 0);
+        if (pCrossings != nullptr)
+        {
+            Uint32 tile = (row * _cCols) + col;
+            pCrossings[cCrossings] = { tile, NeighbourTile(tile, direction), direction };
+        }
+        cCrossings++;
+    }
+    return cCrossings;
+}
+
+// Both ends of every crossing are nodes, numbered a cluster at a time.  Each node gets an edge
+// across for each of its crossings and one to every node of its own cluster it can get to without
+// leaving the cluster
+void PathHierarchy::BuildEdges(const Crossing *pCrossings, Uint32 cCrossings, Uint32 *pTileNodes)
+{
+    Uint32 cTiles = static_cast<Uint32>(_cRows) * _cCols;
+
+    // Count the nodes in each cluster, then turn the counts into where each cluster's nodes start
+    _pClusterNodes = new Uint32[_cClusters + 1] { };
+    for (Uint32 i = 0; i < cCrossings; i++)
+    {
+        Uint32 tiles[2] = { pCrossings[i].fromTile, pCrossings[i].toTile };
+        for (size_t end = 0; end < SDL_arraysize(tiles); end++)
+        {
+            if (pTileNodes[tiles[end]] == c_invalid)
+            {
+                pTileNodes[tiles[end]] = 0;
+                _pClusterNodes[ClusterOf(tiles[end]) + 1]++;
+            }
+        }
+    }
+    for (Uint32 cluster = 0; cluster < _cClusters; cluster++)
+    {
+        _pClusterNodes[cluster + 1] += _pClusterNodes[cluster];
+    }
+    _cNodes = _pClusterNodes[_cClusters];
+
+    _pNodeTiles = new Uint32[SDL_max(_cNodes, 1u)];
+    Uint32 *pNextNode = new Uint32[_cClusters];
+    SDL_memcpy(pNextNode, _pClusterNodes, _cClusters * sizeof(Uint32));
+    for (Uint32 tile = 0; tile < cTiles; tile++)
+    {
+        if (pTileNodes[tile] != c_invalid)
+        {
+            Uint32 node = pNextNode[ClusterOf(tile)]++;
+            pTileNodes[tile] = node;
+            _pNodeTiles[node] = tile;
+        }
+    }
+    delete[] pNextNode;
+
+    // Room for the most each node could have, packed down once we know
+    Uint32 *pCrossingCounts = new Uint32[SDL_max(_cNodes, 1u)] { };
+    for (Uint32 i = 0; i < cCrossings; i++)
+    {
+        pCrossingCounts[pTileNodes[pCrossings[i].fromTile]]++;
+        pCrossingCounts[pTileNodes[pCrossings[i].toTile]]++;
+    }
+    Uint32 *pBase = new Uint32[_cNodes + 1];
+    pBase[0] = 0;
+    for (Uint32 node = 0; node < _cNodes; node++)
+    {
+        Uint32 cluster = ClusterOf(_pNodeTiles[node]);
+        pBase[node + 1] = pBase[node] + pCrossingCounts[node] + (_pClusterNodes[cluster + 1] - _pClusterNodes[cluster] - 1);
+    }
+    Edge *pScratch = new Edge[SDL_max(pBase[_cNodes], 1u)];
+    Uint32 *pCounts = new Uint32[SDL_max(_cNodes, 1u)] { };
+
+    for (Uint32 i = 0; i < cCrossings; i++)
+    {
+        Uint32 from = pTileNodes[pCrossings[i].fromTile];
+        Uint32 to = pTileNodes[pCrossings[i].toTile];
+        pScratch[pBase[from] + pCounts[from]++] = { to, 1, static_cast<Uint8>(pCrossings[i].direction) };
+        pScratch[pBase[to] + pCounts[to]++] = { from, 1, static_cast<Uint8>(Opposite(pCrossings[i].direction)) };
+    }
+
+    for (Uint32 cluster = 0; cluster < _cClusters; cluster++)
+    {
+        for (Uint32 from = _pClusterNodes[cluster]; from < _pClusterNodes[cluster + 1]; from++)
+        {
+            SearchCluster(_pNodeTiles[from], Direction::None);
+            for (Uint32 to = _pClusterNodes[cluster]; to < _pClusterNodes[cluster + 1]; to++)
+            {
+                Uint16 distance = _localDistance[LocalIndex(_pNodeTiles[to])];
+                if ((to != from) && (distance != c_unreachedLocal))
+                {
+                    pScratch[pBase[from] + pCounts[from]++] = { to, distance, static_cast<Uint8>(Direction::None) };
+                }
+            }
+        }
+    }
+
+    _pEdgeStart = new Uint32[_cNodes + 1];
+    _pEdgeStart[0] = 0;
+    for (Uint32 node = 0; node < _cNodes; node++)
+    {
+        _pEdgeStart[node + 1] = _pEdgeStart[node] + pCounts[node];
+    }
+    _cEdges = _pEdgeStart[_cNodes];
+    _pEdges = new Edge[SDL_max(_cEdges, 1u)];
+    for (Uint32 node = 0; node < _cNodes; node++)
+    {
+        SDL_memcpy(&_pEdges[_pEdgeStart[node]], &pScratch[pBase[node]], pCounts[node] * sizeof(Edge));
+    }
+
+    delete[] pCounts;
+    delete[] pScratch;
+    delete[] pBase;
+    delete[] pCrossingCounts;
+}
+
+// Breadth first out from the tile without leaving its cluster, recording the first move of the
+// way to each tile.  The first move can't be straight back against heading
+void PathHierarchy::SearchCluster(Uint32 tile, Direction heading)
+{
+    Uint32 cluster = ClusterOf(tile);
+    SDL_memset(_localDistance, 0xFF, sizeof(_localDistance));
+    _localDistance[LocalIndex(tile)] = 0;
+    _localFirstMove[LocalIndex(tile)] = static_cast<Uint8>(Direction::None);
+
+    Uint32 head = 0;
+    Uint32 tail = 0;
+    _localQueue[tail++] = tile;
+    while (head < tail)
+    {
+        Uint32 current = _localQueue[head++];
+        Uint32 local = LocalIndex(current);
+        for (int index = 0; index < 4; index++)
+        {
+            Direction direction = static_cast<Direction>(index);
+            if (((_pExits[current] & (1 << index)) == 0) ||
+                ((current == tile) && (heading != Direction::None) && (direction == Opposite(heading))))
+            {
+                continue;
+            }
+
+            Uint32 nextTile = NeighbourTile(current, direction);
+            Uint32 nextLocal = LocalIndex(nextTile);
+            if ((_localDistance[nextLocal] == c_unreachedLocal) && (ClusterOf(nextTile) == cluster))
+            {
+                _localDistance[nextLocal] = _localDistance[local] + 1;
+                _localFirstMove[nextLocal] = (current == tile) ? static_cast<Uint8>(index) : _localFirstMove[local];
+                _localQueue[tail++] = nextTile;
+            }
+        }
+    }
+}
+
+// The search already going for this goal, or the least recently used one started over.  A new
+// search starts from every node of the goal's cluster that can get to the goal inside it
+PathHierarchy::Search& PathHierarchy::SearchFor(Uint32 goalTile)
+{
+    _cQueries++;
+    Search *pOldest = &_searches[0];
+    for (size_t i = 0; i < c_cSearches; i++)
+    {
+        if (_searches[i].goalTile == goalTile)
+        {
+            _searches[i].lastUsed = _cQueries;
+            return _searches[i];
+        }
+        if (_searches[i].lastUsed < pOldest->lastUsed)
+        {
+            pOldest = &_searches[i];
+        }
+    }
+
+    Search &search = *pOldest;
+    search.goalTile = goalTile;
+    search.lastUsed = _cQueries;
+    search.cHeap = 0;
+    SDL_memset(search.pDistance, 0xFF, _cNodes * sizeof(Uint32));
+    SDL_memset(search.pSettled, 0, _cNodes * sizeof(Uint8));
+    SDL_memset(search.pHeapIndex, 0xFF, _cNodes * sizeof(Uint32));
+
+    SearchCluster(goalTile, Direction::None);
+    Uint32 cluster = ClusterOf(goalTile);
+    for (Uint32 node = _pClusterNodes[cluster]; node < _pClusterNodes[cluster + 1]; node++)
+    {
+        Uint16 distance = _localDistance[LocalIndex(_pNodeTiles[node])];
+        if (distance != c_unreachedLocal)
+        {
+            search.pDistance[node] = distance;
+            Push(search, node);
+        }
+    }
+    return search;
+}
+
+// Put a node on the heap, or move it up if it's already there and its distance just got shorter.
+// Ties go to the lower numbered node so a search settles in the same order however it's resumed
+void PathHierarchy::Push(Search &search, Uint32 node)
+{
+    Uint32 index = search.pHeapIndex[node];
+    if (index == c_invalid)
+    {
+        index = search.cHeap++;
+    }
+    while (index > 0)
+    {
+        Uint32 parent = (index - 1) / 2;
+        if (!IsCloser(search, node, search.pHeap[parent]))
+        {
+            break;
+        }
+        search.pHeap[index] = search.pHeap[parent];
+        search.pHeapIndex[search.pHeap[index]] = index;
+        index = parent;
+    }
+    search.pHeap[index] = node;
+    search.pHeapIndex[node] = index;
+}
+
+// Take the closest node off the heap and relax its edges (the moves are two way, so the edges out
+// of a node are also the edges into it).  Returns the node, c_invalid once there are none
+Uint32 PathHierarchy::SettleNext(Search &search)
+{
+    if (search.cHeap == 0)
+    {
+        return c_invalid;
+    }
+
+    Uint32 node = search.pHeap[0];
+    Uint32 last = search.pHeap[--search.cHeap];
+    search.pHeapIndex[node] = c_invalid;
+    if (search.cHeap > 0)
+    {
+        Uint32 index = 0;
+        for (;;)
+        {
+            Uint32 child = (index * 2) + 1;
+            if (child >= search.cHeap)
+            {
+                break;
+            }
+            if ((child + 1 < search.cHeap) && IsCloser(search, search.pHeap[child + 1], search.pHeap[child]))
+            {
+                child++;
+            }
+            if (!IsCloser(search, search.pHeap[child], last))
+            {
+                break;
+            }
+            search.pHeap[index] = search.pHeap[child];
+            search.pHeapIndex[search.pHeap[index]] = index;
+            index = child;
+        }
+        search.pHeap[index] = last;
+        search.pHeapIndex[last] = index;
+    }
+
+    search.pSettled[node] = 1;
+    Uint32 distance = search.pDistance[node];
+    for (Uint32 edge = _pEdgeStart[node]; edge < _pEdgeStart[node + 1]; edge++)
+    {
+        Uint32 next = _pEdges[edge].node;
+        Uint32 nextDistance = distance + _pEdges[edge].cost;
+        if (nextDistance < search.pDistance[next])
+        {
+            search.pDistance[next] = nextDistance;
+            Push(search, next);
+        }
+    }
+    return node;
+}
+
+// Either straight to the goal inside our cluster, or to one of its nodes and across a crossing then
+// the rest of the way over the graph, whichever is shortest
+Direction PathHierarchy::NextDirection(Uint16 row, Uint16 col, Direction heading, Uint16 targetRow, Uint16 targetCol)
+{
+    if ((_pExits == nullptr) || (row >= _cRows) || (col >= _cCols))
+    {
+        return Direction::None;
+    }
+
+    Uint32 tile = (static_cast<Uint32>(row) * _cCols) + col;
+    if (_pExits[tile] == 0)
+    {
+        return Direction::None;
+    }
+
+    // Targets are allowed to be off the map (e.g. Inky's), negative values having wrapped around
+    if (targetRow >= _cRows)
+    {
+        targetRow = (targetRow > 0x7FFF) ? 0 : _cRows - 1;
+    }
+    if (targetCol >= _cCols)
+    {
+        targetCol = (targetCol > 0x7FFF) ? 0 : _cCols - 1;
+    }
+    Uint32 goalTile = _pNearestTiles[(static_cast<Uint32>(targetRow) * _cCols) + targetCol];
+    if (goalTile == tile)
+    {
+        // Already there, any direction will do
+        return Direction::None;
+    }
+
+    Search &search = SearchFor(goalTile);
+    SearchCluster(tile, heading);
+
+    Uint32 directBest = c_invalid;
+    Direction directResult = Direction::None;
+    Uint32 cluster = ClusterOf(tile);
+    if (ClusterOf(goalTile) == cluster)
+    {
+        Uint32 local = LocalIndex(goalTile);
+        if (_localDistance[local] != c_unreachedLocal)
+        {
+            directBest = _localDistance[local];
+            directResult = static_cast<Direction>(_localFirstMove[local]);
+        }
+    }
+
+    // Only settled nodes across our crossings count.  The search carries on until nothing left on
+    // it could beat or tie the best so far, and ties always go the same way (the first in node
+    // order), which keeps the answer the same however far other ghosts had already taken it
+    Uint32 best = directBest;
+    Direction result = directResult;
+    Uint32 firstNode = _pClusterNodes[cluster];
+    Uint32 endNode = _pClusterNodes[cluster + 1];
+    for (;;)
+    {
+        best = directBest;
+        result = directResult;
+        for (Uint32 node = firstNode; node < endNode; node++)
+        {
+            Uint32 local = LocalIndex(_pNodeTiles[node]);
+            if (_localDistance[local] == c_unreachedLocal)
+            {
+                continue;
+            }
+
+            for (Uint32 edge = _pEdgeStart[node]; edge < _pEdgeStart[node + 1]; edge++)
+            {
+                Direction crossing = static_cast<Direction>(_pEdges[edge].direction);
+                Uint32 across = _pEdges[edge].node;
+                if ((crossing == Direction::None) || (search.pSettled[across] == 0))
+                {
+                    continue;
+                }
+
+                // Standing on the crossing, so crossing it is the first move
+                Direction move = (_localDistance[local] == 0) ? crossing : static_cast<Direction>(_localFirstMove[local]);
+                if ((_localDistance[local] == 0) && (heading != Direction::None) && (move == Opposite(heading)))
+                {
+                    continue;
+                }
+
+                Uint32 total = _localDistance[local] + 1 + search.pDistance[across];
+                if (total < best)
+                {
+                    best = total;
+                    result = move;
+                }
+            }
+        }
+
+        bool fNewCandidate = false;
+        while (!fNewCandidate && (search.cHeap > 0) && (search.pDistance[search.pHeap[0]] + 1 <= best))
+        {
+            Uint32 node = SettleNext(search);
+            if (node == c_invalid)
+            {
+                break;
+            }
+
+            // Anything with a crossing into our cluster might be a better way out
+            for (Uint32 edge = _pEdgeStart[node]; edge < _pEdgeStart[node + 1]; edge++)
+            {
+                if ((_pEdges[edge].direction != static_cast<Uint8>(Direction::None)) &&
+                    (_pEdges[edge].node >= firstNode) && (_pEdges[edge].node < endNode))
+                {
+                    fNewCandidate = true;
+                }
+            }
+        }
+
+        if (!fNewCandidate)
+        {
+            break;
+        }
+    }
+
+    // Nothing found when the way goes back through this tile (round a dead end) or leaves the
+    // cluster somewhere that isn't a node.  Both only happen in corridors, where there's one move
+    if (result == Direction::None)
+    {
+        Uint8 exits = _pExits[tile];
+        if (heading != Direction::None)
+        {
+            exits &= ~(1 << static_cast<int>(Opposite(heading)));
+        }
+        for (int index = 0; index < 4; index++)
+        {
+            if (exits == (1 << index))
+            {
+                result = static_cast<Direction>(index);
+            }
+        }
+    }
+    return result;
+}
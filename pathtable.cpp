@@ -0,0 +1,268 @@
+#include "include/pathtable.h"
+
+using namespace XplatGameTutorial::PacManClone;
+
+PathTable::PathTable() :
+    _cRows(0),
+    _cCols(0),
+    _cNodes(0),
+    _pNodeTiles(nullptr),
+    _pTileNodes(nullptr),
+    _pNearestNodes(nullptr),
+    _pNeighbours(nullptr),
+    _pNextDirections(nullptr)
+{
+}
+
+PathTable::~PathTable()
+{
+    delete[] _pNodeTiles;
+    delete[] _pTileNodes;
+    delete[] _pNearestNodes;
+    delete[] _pNeighbours;
+    delete[] _pNextDirections;
+}
+
+// Tile index of the neighbour in the given direction, wrapping around the edges like the warp tunnel
+Uint16 PathTable::NeighbourTile(Uint16 tile, Direction direction)
+{
+    Uint16 row = tile / _cCols;
+    Uint16 col = tile % _cCols;
+    switch (direction)
+    {
+    case Direction::Up:
+        row = (row == 0) ? _cRows - 1 : row - 1;
+        break;
+    case Direction::Down:
+        row = (row == _cRows - 1) ? 0 : row + 1;
+        break;
+    case Direction::Left:
+        col = (col == 0) ? _cCols - 1 : col - 1;
+        break;
+    case Direction::Right:
+        col = (col == _cCols - 1) ? 0 : col + 1;
+        break;
+    case Direction::None:
+        break;
+    }
+    return (row * _cCols) + col;
+}
+
+bool PathTable::Build(Uint16 rows, Uint16 cols, const Uint8 *pExitMasks, Uint16 startRow, Uint16 startCol)
+{
+    SDL_assert(_pNodeTiles == nullptr);
+
+    // Tiles and nodes are numbered in 16 bits with the top value kept for c_invalidNode
+    if ((static_cast<Uint32>(rows) * cols >= c_invalidNode) || (startRow >= rows) || (startCol >= cols) ||
+        (pExitMasks[(startRow * cols) + startCol] == 0))
+    {
+        printf("PathTable::Build() : can't build a table for a %ux%u map from [%u][%u]\n", rows, cols, startRow, startCol);
+        return false;
+    }
+
+    _cRows = rows;
+    _cCols = cols;
+    Uint32 cTiles = rows * cols;
+    Direction directions[] = { Direction::Up, Direction::Down, Direction::Left, Direction::Right };
+
+    // Flood out from the start tile to find every tile in the playing area, in flood order
+    _pTileNodes = new Uint16[cTiles];
+    SDL_memset(_pTileNodes, 0xFF, cTiles * sizeof(Uint16));
+    _pNodeTiles = new Uint16[cTiles];
+
+    Uint16 startTile = (startRow * cols) + startCol;
+    _pNodeTiles[0] = startTile;
+    _pTileNodes[startTile] = 0;
+    _cNodes = 1;
+    for (Uint16 node = 0; node < _cNodes; node++)
+    {
+        Uint16 tile = _pNodeTiles[node];
+        for (size_t index = 0; index < SDL_arraysize(directions); index++)
+        {
+            if ((pExitMasks[tile] & (1 << static_cast<int>(directions[index]))) != 0)
+            {
+                Uint16 nextTile = NeighbourTile(tile, directions[index]);
+                if (_pTileNodes[nextTile] == c_invalidNode)
+                {
+                    _pTileNodes[nextTile] = _cNodes;
+                    _pNodeTiles[_cNodes++] = nextTile;
+                }
+            }
+        }
+    }
+
+    _pNeighbours = new Uint16[_cNodes * 4];
+    for (Uint16 node = 0; node < _cNodes; node++)
+    {
+        for (size_t index = 0; index < SDL_arraysize(directions); index++)
+        {
+            Uint16 tile = _pNodeTiles[node];
+            bool fOpen = (pExitMasks[tile] & (1 << static_cast<int>(directions[index]))) != 0;
+            _pNeighbours[(node * 4) + index] = fOpen ? _pTileNodes[NeighbourTile(tile, directions[index])] : c_invalidNode;
+        }
+    }
+
+    BuildNearestNodes();
+
+    // One search per target fills in that target's slice of the table
+    Uint32 cStates = _cNodes * c_headingsPerNode;
+    _pNextDirections = new Uint8[((static_cast<size_t>(cStates) * _cNodes) + 3) / 4] { };
+    Uint16 *pDistance = new Uint16[cStates];
+    Uint32 *pQueue = new Uint32[cStates];
+    for (Uint16 target = 0; target < _cNodes; target++)
+    {
+        SearchFromTarget(target, pDistance, pQueue);
+    }
+    delete[] pQueue;
+    delete[] pDistance;
+    return true;
+}
+
+// Every tile gets the closest node by a plain grid flood (walls ignored) out from all the nodes at once
+void PathTable::BuildNearestNodes()
+{
+    Uint32 cTiles = _cRows * _cCols;
+    _pNearestNodes = new Uint16[cTiles];
+    SDL_memset(_pNearestNodes, 0xFF, cTiles * sizeof(Uint16));
+
+    Uint16 *pQueue = new Uint16[cTiles];
+    Uint32 head = 0;
+    Uint32 tail = 0;
+    for (Uint16 node = 0; node < _cNodes; node++)
+    {
+        _pNearestNodes[_pNodeTiles[node]] = node;
+        pQueue[tail++] = _pNodeTiles[node];
+    }
+
+    while (head < tail)
+    {
+        Uint16 tile = pQueue[head++];
+        Uint16 row = tile / _cCols;
+        Uint16 col = tile % _cCols;
+        Uint16 neighbours[4] = { c_invalidNode, c_invalidNode, c_invalidNode, c_invalidNode };
+        if (row > 0) neighbours[0] = tile - _cCols;
+        if (row < _cRows - 1) neighbours[1] = tile + _cCols;
+        if (col > 0) neighbours[2] = tile - 1;
+        if (col < _cCols - 1) neighbours[3] = tile + 1;
+
+        for (size_t index = 0; index < SDL_arraysize(neighbours); index++)
+        {
+            if ((neighbours[index] != c_invalidNode) && (_pNearestNodes[neighbours[index]] == c_invalidNode))
+            {
+                _pNearestNodes[neighbours[index]] = _pNearestNodes[tile];
+                pQueue[tail++] = neighbours[index];
+            }
+        }
+    }
+    delete[] pQueue;
+}
+
+// Breadth first search backwards from the target over (node, heading) states.  A ghost at node n that
+// arrived heading h can take any open exit except the reverse of h, so state (n, h) is a predecessor of
+// (m, d) when m is n's neighbour in direction d and d != Opposite(h).  The first time a state is reached
+// gives its shortest distance and the exit to record
+void PathTable::SearchFromTarget(Uint16 targetNode, Uint16 *pDistance, Uint32 *pQueue)
+{
+    const Uint32 cStates = _cNodes * c_headingsPerNode;
+    const Uint16 c_unreached = 0xFFFF;
+    const size_t tableBase = static_cast<size_t>(targetNode) * cStates;
+    SDL_memset(pDistance, 0xFF, cStates * sizeof(Uint16));
+
+    Uint32 head = 0;
+    Uint32 tail = 0;
+    for (Uint32 heading = 0; heading < c_headingsPerNode; heading++)
+    {
+        Uint32 state = (targetNode * c_headingsPerNode) + heading;
+        pDistance[state] = 0;
+        pQueue[tail++] = state;
+    }
+
+    while (head < tail)
+    {
+        Uint32 state = pQueue[head++];
+        Uint16 node = static_cast<Uint16>(state / c_headingsPerNode);
+        Direction arrivedHeading = static_cast<Direction>(state % c_headingsPerNode);
+        if (arrivedHeading == Direction::None)
+        {
+            // Only reachable as a starting state, nothing arrives heading "None"
+            continue;
+        }
+
+        // The tile we came from is the neighbour behind us, and it moved in arrivedHeading to get here
+        Uint16 fromNode = _pNeighbours[(node * 4) + static_cast<int>(Opposite(arrivedHeading))];
+        if (fromNode == c_invalidNode)
+        {
+            continue;
+        }
+
+        for (Uint32 heading = 0; heading < c_headingsPerNode; heading++)
+        {
+            if ((static_cast<Direction>(heading) != Direction::None) &&
+                (Opposite(static_cast<Direction>(heading)) == arrivedHeading))
+            {
+                // Would have to reverse to make this move
+                continue;
+            }
+
+            Uint32 fromState = (fromNode * c_headingsPerNode) + heading;
+            if (pDistance[fromState] == c_unreached)
+            {
+                pDistance[fromState] = pDistance[state] + 1;
+                SetEntry(static_cast<Uint32>(tableBase + fromState), arrivedHeading);
+                pQueue[tail++] = fromState;
+            }
+        }
+    }
+
+    // Anything left over can't get there without reversing (or at all), just take the first legal exit
+    for (Uint32 state = 0; state < cStates; state++)
+    {
+        if (pDistance[state] == c_unreached)
+        {
+            Uint16 node = static_cast<Uint16>(state / c_headingsPerNode);
+            Direction heading = static_cast<Direction>(state % c_headingsPerNode);
+            for (int index = 0; index < 4; index++)
+            {
+                if ((_pNeighbours[(node * 4) + index] != c_invalidNode) &&
+                    ((heading == Direction::None) || (Opposite(heading) != static_cast<Direction>(index))))
+                {
+                    SetEntry(static_cast<Uint32>(tableBase + state), static_cast<Direction>(index));
+                    break;
+                }
+            }
+        }
+    }
+}
+
+Direction PathTable::NextDirection(Uint16 row, Uint16 col, Direction heading, Uint16 targetRow, Uint16 targetCol)
+{
+    if ((_pNextDirections == nullptr) || (row >= _cRows) || (col >= _cCols))
+    {
+        return Direction::None;
+    }
+
+    Uint16 node = _pTileNodes[(row * _cCols) + col];
+    if (node == c_invalidNode)
+    {
+        return Direction::None;
+    }
+
+    // Targets are allowed to be off the map (e.g. Inky's), negative values having wrapped around
+    if (targetRow >= _cRows)
+    {
+        targetRow = (targetRow > 0x7FFF) ? 0 : _cRows - 1;
+    }
+    if (targetCol >= _cCols)
+    {
+        targetCol = (targetCol > 0x7FFF) ? 0 : _cCols - 1;
+    }
+    Uint16 targetNode = _pNearestNodes[(targetRow * _cCols) + targetCol];
+    if (targetNode == node)
+    {
+        // Already there, any direction will do
+        return Direction::None;
+    }
+
+    size_t index = (static_cast<size_t>(targetNode) * _cNodes * c_headingsPerNode) + (node * c_headingsPerNode) + static_cast<int>(heading);
+    return static_cast<Direction>((_pNextDirections[index >> 2] >> ((index & 3) * 2)) & 3);
+}
@@ -15,50 +15,33 @@ bool Pinky::Initialize()
     // the specific loading data
     InitializeCommon();
     LoadFrames(0, 0, 96, 8);
-    _scatterRow = Constants::PinkyScatterRow;
-    _scatterCol = Constants::PinkyScatterCol;
     _targetColor = Constants::PinkyDrawColor;
     return true;
 }
 
 bool Pinky::Reset(Maze *pMaze)
 {
+    const MazeLayout &layout = pMaze->Layout();
+    const MazeLayout::Cell &start = layout.ghostStarts[1];
+    _scatterRow = layout.scatterTargets[1].row;
+    _scatterCol = layout.scatterTargets[1].col;
+
     SetAnimation(Constants::AnimationIndexUp);
-    SDL_Point playerStartCoord = pMaze->GetTileCoordinates(Constants::GhostPenRow, Constants::GhostPenCol + 2);
+    SDL_Point playerStartCoord = pMaze->GetTileCoordinates(start.row, start.col);
 
     // There is no "penned" mode, just placement will take care of that.  Pinky is the only
     // ghost that is supposed to start outside of the pen, but since he's the only one for now
     // put him inside to test out that code path.
-    _currentRow = Constants::GhostPenRow;
-    _currentCol = Constants::GhostPenCol + 2;
+    _currentRow = start.row;
+    _currentCol = start.col;
     ResetPosition(playerStartCoord.x, playerStartCoord.y);
-    SetVelocity(0, Constants::GhostBaseSpeed * -1.75);
+    SetVelocity(0, Constants::GhostSpeed * -1);
 
-    SafeDelete<Decision>(_pNextDecision);
-    SafeDelete<Decision>(_pCurrentDecision);
-    _pCurrentDecision = new Decision(Constants::GhostPenRow, Constants::GhostPenCol + 2, CurrentDirection());
+    ResetDecisions(start.row, start.col, CurrentDirection());
     _penTimer.Reset();
     SetPenTimerMax(2000);
     _mode = Mode::Chase;
     _fScatter = false;
 
     return true;
-}
-
-Direction Pinky::MakeBranchDecision(Uint16 nRow, Uint16 nCol, Player* pPlayer, Maze *pMaze)
-{
-    // Pinky's target tile is 4 tiles ahead of the player's current tile
-    Direction result = CurrentDirection();
-
-    SDL_Point playerPoint = { static_cast<int>(pPlayer->X()), static_cast<int>(pPlayer->Y()) };
-    if (_fScatter)
-    {
-        _targetRow = _scatterRow;
-        _targetCol = _scatterCol;
-    }
-    else
-    {
-        pPlayer->GetTilePlayerFacingWithOriginalBug(pMaze, 4, _targetRow, _targetCol);
-    }
-    return ShortestDirectionToTarget(nRow, nCol, _targetRow, _targetCol, pMaze);
 }
\ No newline at end of file
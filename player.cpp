@@ -29,10 +29,11 @@ bool Player::Initialize()
 bool Player::Reset(Maze *pMaze)
 {
     SetAnimation(Constants::AnimationIndexLeft);
-    SDL_Point playerStartCoord = pMaze->GetTileCoordinates(Constants::PlayerStartRow, Constants::PlayerStartCol);
+    const MazeLayout::Cell &start = pMaze->Layout().playerStart;
+    SDL_Point playerStartCoord = pMaze->GetTileCoordinates(start.row, start.col);
     playerStartCoord.x += Constants::TileWidth / 2;
     ResetPosition(playerStartCoord.x, playerStartCoord.y);
-    SetVelocity(Constants::PlayerMaxSpeed * -.75, 0);  // Eventually speeds will be based on level, dots eaten, etc
+    SetVelocity(Constants::PlayerSpeed * -1, 0);
     _mode = Mode::Normal;
     return true;
 }
@@ -84,10 +85,10 @@ void Player::Update(Maze* pMaze, Direction inputDirection)
     case Mode::WarpingIn:
     {
             // Just keep moving until back in view...
-        SDL_Point playerPoint = { static_cast<int>(X()), static_cast<int>(Y()) };
+        SDL_Point playerPoint = { X(), Y() };
         Uint16 row, col;
-        pMaze->GetTileRowCol(playerPoint, row, col);
-        if ((row == Constants::WarpRow) && ((col == Constants::WarpColPlayerLeft + 1) || (col == Constants::WarpColPlayerRight - 1)))
+        if (pMaze->GetTileRowCol(playerPoint, row, col) &&
+            (pMaze->WarpDepth(row, col) == Constants::WarpDepthPlayerIn))
         {
             // Start accepting player input again..
             _mode = Mode::Normal;
@@ -99,7 +100,7 @@ void Player::Update(Maze* pMaze, Direction inputDirection)
 
 void Player::GetTilePlayerFacingWithOriginalBug(Maze* pMaze, Uint16 cSpaces, Uint16 &row, Uint16 &col)
 {
-    SDL_Point playerPoint = { static_cast<int>(X()), static_cast<int>(Y()) };
+    SDL_Point playerPoint = { X(), Y() };
     pMaze->GetTileRowCol(playerPoint, row, col);
 
     Direction playerFacing = Facing();
@@ -127,13 +128,13 @@ void Player::GetTilePlayerFacingWithOriginalBug(Maze* pMaze, Uint16 cSpaces, Uin
         }
         break;
     case Direction::Down:
-        if (row < Constants::MapRows - cSpaces - 1)
+        if (row < pMaze->Rows() - cSpaces - 1)
         {
             row += cSpaces;
         }
         else
         {
-            row = Constants::MapRows - 1;
+            row = pMaze->Rows() - 1;
         }
         break;
     case Direction::Left:
@@ -147,13 +148,13 @@ void Player::GetTilePlayerFacingWithOriginalBug(Maze* pMaze, Uint16 cSpaces, Uin
         }
         break;
     case Direction::Right:
-        if (col < Constants::MapCols - cSpaces - 1)
+        if (col < pMaze->Cols() - cSpaces - 1)
         {
             col += cSpaces;
         }
         else
         {
-            col = Constants::MapCols - 1;
+            col = pMaze->Cols() - 1;
         }
         break;
     case Direction::None:
@@ -169,46 +170,15 @@ void Player::ProcessPlayerInput(Maze* pMaze, Direction direction)
         return;
     }
 
-    SDL_Point playerPoint = { static_cast<int>(X()), static_cast<int>(Y()) };
+    SDL_Point playerPoint = { X(), Y() };
     Uint16 playerRow = 0;
     Uint16 playerCol = 0;
     pMaze->GetTileRowCol(playerPoint, playerRow, playerCol);
 
     // Given a player's current state (location, direction, animation) check if the player can move in a given direction, and if
     // so position the player on the new track at the new velocity
-    // Helper lambda to check the map in a given direction.  I put it here instead of another helper
-    // because it's only useful here now.  Plus I wanted to check the c++11 feature on both compilers :)
-    auto CanMove = [](Direction direction, Uint16 row, Uint16 col) -> SDL_bool
-    {
-        SDL_bool fResult = SDL_FALSE;
-        // Adjust the [row][col] to look at based on direction
-        if (direction == Direction::Up)
-        {
-            row--;
-        }
-        else if (direction == Direction::Down)
-        {
-            row++;
-        }
-        else if (direction == Direction::Left)
-        {
-            col--;
-        }
-        else if (direction == Direction::Right)
-        {
-            col++;
-        }
-        
-        // Check the map, 0s are legal free space
-        if (Constants::CollisionMap[row * Constants::MapCols + col] == 0)
-        {
-            fResult = SDL_TRUE;
-        }
-        return fResult;
-    };
-
     // If we can move and we're not already moving in the direction
-    if ((CanMove(direction, playerRow, playerCol) == SDL_TRUE) &&
+    if ((pMaze->CanExit(playerRow, playerCol, direction) == SDL_TRUE) &&
         (CurrentAnimation() != static_cast<Uint16>(direction)))
     {
         // Set a new animation and position the player with a new velocity
@@ -219,19 +189,19 @@ void Player::ProcessPlayerInput(Maze* pMaze, Direction direction)
         switch (direction)
         {
         case Direction::Up:
-            SetVelocity(0, Constants::PlayerMaxSpeed * -.75);
+            SetVelocity(0, Constants::PlayerSpeed * -1);
             SetAnimation(Constants::AnimationIndexUp);
             break;
         case Direction::Down:
-            SetVelocity(0, Constants::PlayerMaxSpeed * .75);
+            SetVelocity(0, Constants::PlayerSpeed);
             SetAnimation(Constants::AnimationIndexDown);
             break;
         case Direction::Left:
-            SetVelocity(Constants::PlayerMaxSpeed * -.75, 0);
+            SetVelocity(Constants::PlayerSpeed * -1, 0);
             SetAnimation(Constants::AnimationIndexLeft);
             break;
         case Direction::Right:
-            SetVelocity(Constants::PlayerMaxSpeed * .75, 0);
+            SetVelocity(Constants::PlayerSpeed, 0);
             SetAnimation(Constants::AnimationIndexRight);
             break;
         case Direction::None:
@@ -243,7 +213,7 @@ void Player::ProcessPlayerInput(Maze* pMaze, Direction direction)
 // Don't allow the player to wander through a solid wall
 void Player::DoBoundsCheck(Maze* pMaze)
 {
-    SDL_Point playerPoint = { static_cast<int>(X()), static_cast<int>(Y()) };
+    SDL_Point playerPoint = { X(), Y() };
 
     // Need to check bounds in direction moving (account for width of half the sprite)
     // This is because the sprite is double the size of the tiles and placed along the centerline
@@ -0,0 +1,222 @@
+#include "include/profiler.h"
+#include <algorithm>
+
+using namespace XplatGameTutorial::PacManClone;
+
+Profiler::Profiler() :
+    _fEnabled(false),
+    _fOverlay(false),
+    _counterFrequency(SDL_GetPerformanceFrequency()),
+    _lastReportCounter(0)
+{
+    for (int phase = 0; phase < c_cPhases; phase++)
+    {
+        _frameCounts[phase] = 0;
+        _fPhaseActive[phase] = false;
+        _cSamples[phase] = 0;
+        _iNextSample[phase] = 0;
+        _nsRunTotal[phase] = 0;
+        _cRunSamples[phase] = 0;
+        _nsRunMin[phase] = SDL_MAX_UINT32;
+        _nsRunMax[phase] = 0;
+    }
+}
+
+void Profiler::Enable(bool fEnable)
+{
+    _fEnabled = fEnable;
+    if (!_fEnabled)
+    {
+        _fOverlay = false;
+    }
+}
+
+// The overlay needs the timers, so showing it turns them on (and they stay on for the CSV)
+void Profiler::ToggleOverlay()
+{
+    _fOverlay = !_fOverlay;
+    if (_fOverlay)
+    {
+        _fEnabled = true;
+    }
+}
+
+void Profiler::CommitFrame()
+{
+    if (!_fEnabled)
+    {
+        return;
+    }
+
+    for (int phase = 0; phase < c_cPhases; phase++)
+    {
+        if (_fPhaseActive[phase])
+        {
+            Uint32 nsSample = CountsToNanoseconds(_frameCounts[phase]);
+            _samples[phase][_iNextSample[phase]] = nsSample;
+            _iNextSample[phase] = (_iNextSample[phase] + 1) % c_cSamples;
+            _cSamples[phase] = SDL_min(_cSamples[phase] + 1, c_cSamples);
+
+            _nsRunTotal[phase] += nsSample;
+            _cRunSamples[phase]++;
+            _nsRunMin[phase] = SDL_min(_nsRunMin[phase], nsSample);
+            _nsRunMax[phase] = SDL_max(_nsRunMax[phase], nsSample);
+
+            _frameCounts[phase] = 0;
+            _fPhaseActive[phase] = false;
+        }
+    }
+
+    if (_fOverlay)
+    {
+        Uint64 nowCounter = SDL_GetPerformanceCounter();
+        if (nowCounter - _lastReportCounter >= _counterFrequency)
+        {
+            PrintStats();
+            _lastReportCounter = nowCounter;
+        }
+    }
+}
+
+Profiler::PhaseStats Profiler::GetStats(Phase phase)
+{
+    int index = static_cast<int>(phase);
+    PhaseStats stats = { _cSamples[index], 0, 0, 0, 0 };
+    if (stats.cSamples != 0)
+    {
+        // Only a few hundred samples, a sorted copy is cheap enough for a once a second report
+        Uint32 sorted[c_cSamples];
+        SDL_memcpy(sorted, _samples[index], stats.cSamples * sizeof(Uint32));
+        std::sort(sorted, sorted + stats.cSamples);
+
+        Uint64 nsTotal = 0;
+        for (Uint32 i = 0; i < stats.cSamples; i++)
+        {
+            nsTotal += sorted[i];
+        }
+        stats.nsMin = sorted[0];
+        stats.nsAvg = static_cast<Uint32>(nsTotal / stats.cSamples);
+        stats.nsP99 = sorted[((stats.cSamples * 99) - 1) / 100];
+        stats.nsMax = sorted[stats.cSamples - 1];
+    }
+    return stats;
+}
+
+const char *Profiler::PhaseName(Phase phase)
+{
+    static const char * const names[] =
+    {
+        "ProcessInput",
+        "PlayerUpdate",
+        "PelletCollision",
+        "GhostUpdate0",
+        "GhostUpdate1",
+        "GhostUpdate2",
+        "GhostUpdate3",
+        "CrowdUpdate",
+        "GhostCollision",
+        "MazeRender",
+        "SpriteRender",
+        "AITargetRender",
+        "Present"
+    };
+    static_assert(SDL_arraysize(names) == static_cast<size_t>(Phase::Count), "Name every phase");
+    return names[static_cast<int>(phase)];
+}
+
+void Profiler::PrintStats()
+{
+    printf("%-16s %10s %10s %10s (ns)\n", "Phase", "min", "avg", "p99");
+    for (int phase = 0; phase < c_cPhases; phase++)
+    {
+        PhaseStats stats = GetStats(static_cast<Phase>(phase));
+        if (stats.cSamples != 0)
+        {
+            printf("%-16s %10u %10u %10u\n", PhaseName(static_cast<Phase>(phase)), stats.nsMin, stats.nsAvg, stats.nsP99);
+        }
+    }
+}
+
+void Profiler::RenderOverlay(SDL_Renderer *pSDLRenderer)
+{
+    if (!_fOverlay)
+    {
+        return;
+    }
+
+    // Full bar width is one frame at 60Hz
+    const int c_xOrigin = 8;
+    const int c_yOrigin = 8;
+    const int c_cxBudget = 320;
+    const int c_cyRow = 10;
+    const Uint32 c_nsBudget = 1000000000 / Constants::FramesPerSecond;
+
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(pSDLRenderer, &r, &g, &b, &a);
+
+    SDL_Rect background = { c_xOrigin - 4, c_yOrigin - 4, c_cxBudget + 8, (c_cPhases * c_cyRow) + 8 };
+    SDL_SetRenderDrawColor(pSDLRenderer, 0, 0, 0, 255);
+    SDL_RenderFillRect(pSDLRenderer, &background);
+
+    for (int phase = 0; phase < c_cPhases; phase++)
+    {
+        PhaseStats stats = GetStats(static_cast<Phase>(phase));
+        int y = c_yOrigin + (phase * c_cyRow);
+
+        // Alternate the colors so neighbouring rows can be told apart
+        SDL_SetRenderDrawColor(pSDLRenderer, (phase & 1) ? 80 : 60, (phase & 1) ? 200 : 160, 80, 255);
+        SDL_Rect bar = { c_xOrigin, y, static_cast<int>(SDL_min(stats.nsAvg, c_nsBudget) * c_cxBudget / c_nsBudget), c_cyRow - 3 };
+        if (bar.w == 0 && stats.cSamples != 0)
+        {
+            bar.w = 1;
+        }
+        SDL_RenderFillRect(pSDLRenderer, &bar);
+
+        // Whisker from min to p99
+        int xMin = c_xOrigin + static_cast<int>(SDL_min(stats.nsMin, c_nsBudget) * c_cxBudget / c_nsBudget);
+        int xP99 = c_xOrigin + static_cast<int>(SDL_min(stats.nsP99, c_nsBudget) * c_cxBudget / c_nsBudget);
+        SDL_SetRenderDrawColor(pSDLRenderer, 255, 255, 255, 255);
+        SDL_RenderDrawLine(pSDLRenderer, xMin, y + ((c_cyRow - 3) / 2), xP99, y + ((c_cyRow - 3) / 2));
+        SDL_RenderDrawLine(pSDLRenderer, xP99, y, xP99, y + c_cyRow - 4);
+    }
+
+    SDL_SetRenderDrawColor(pSDLRenderer, r, g, b, a);
+}
+
+bool Profiler::WriteCsv(const char *pszPath)
+{
+    bool fAny = false;
+    for (int phase = 0; phase < c_cPhases; phase++)
+    {
+        fAny = fAny || (_cRunSamples[phase] != 0);
+    }
+    if (!fAny)
+    {
+        return false;
+    }
+
+    SDL_RWops *pFile = SDL_RWFromFile(pszPath, "w");
+    if (pFile == nullptr)
+    {
+        printf("Failed to write profile %s! SDL Error: %s\n", pszPath, SDL_GetError());
+        return false;
+    }
+
+    char line[256];
+    int cch = SDL_snprintf(line, sizeof(line), "phase,samples,min_ns,avg_ns,p99_ns,max_ns,run_samples,run_min_ns,run_avg_ns,run_max_ns\n");
+    SDL_RWwrite(pFile, line, 1, cch);
+    for (int phase = 0; phase < c_cPhases; phase++)
+    {
+        if (_cRunSamples[phase] != 0)
+        {
+            PhaseStats stats = GetStats(static_cast<Phase>(phase));
+            cch = SDL_snprintf(line, sizeof(line), "%s,%u,%u,%u,%u,%u,%u,%u,%u,%u\n", PhaseName(static_cast<Phase>(phase)),
+                stats.cSamples, stats.nsMin, stats.nsAvg, stats.nsP99, stats.nsMax,
+                _cRunSamples[phase], _nsRunMin[phase], static_cast<Uint32>(_nsRunTotal[phase] / _cRunSamples[phase]), _nsRunMax[phase]);
+            SDL_RWwrite(pFile, line, 1, cch);
+        }
+    }
+    SDL_RWclose(pFile);
+    printf("Profile written to %s\n", pszPath);
+    return true;
+}
@@ -0,0 +1,252 @@
+#include "include/rolloutfarm.h"
+
+using namespace XplatGameTutorial::PacManClone;
+
+RolloutFarm::RolloutFarm() :
+    _cWorkers(0),
+    _pWorkers(nullptr),
+    _pTilesTexture(nullptr),
+    _pSpriteTexture(nullptr),
+    _pStartSnapshot(nullptr),
+    _cMaxTicks(0),
+    _policy(nullptr),
+    _pContext(nullptr),
+    _stats({ 0, 0, 0, 0 })
+{
+}
+
+RolloutFarm::~RolloutFarm()
+{
+    // The workers' sprites point at the textures, so they go first
+    delete[] _pWorkers;
+    delete _pStartSnapshot;
+    delete _pSpriteTexture;
+    delete _pTilesTexture;
+}
+
+bool RolloutFarm::Initialize(Uint32 cWorkers, bool fTruePathing, const MazeLayout &layout)
+{
+    SDL_assert(_pWorkers == nullptr);
+
+    // Every game starts from a snapshot, which only has room for so many pellets
+    if (static_cast<size_t>(layout.rows) * layout.cols > Constants::MaxSnapshotTiles)
+    {
+        printf("RolloutFarm::Initialize() : a %ux%u maze is too big for rollouts\n", layout.rows, layout.cols);
+        return false;
+    }
+
+    _cWorkers = (cWorkers != 0) ? cWorkers : static_cast<Uint32>(SDL_max(SDL_GetCPUCount(), 1));
+    _pTilesTexture = new TextureWrapper(Constants::TileTextureWidth, Constants::TileTextureHeight);
+    _pSpriteTexture = new TextureWrapper(Constants::SpriteTextureWidth, Constants::SpriteTextureHeight);
+    _pStartSnapshot = new GameSnapshot();
+    _pWorkers = new Worker[_cWorkers];
+
+    for (Uint32 i = 0; i < _cWorkers; i++)
+    {
+        Worker &worker = _pWorkers[i];
+        worker.pFarm = this;
+        worker.pThread = nullptr;
+        worker.lock = 0;
+        worker.next = 0;
+        worker.end = 0;
+        worker.pResults = nullptr;
+        worker.cResults = 0;
+        worker.cResultsMax = 0;
+        worker.cSteals = 0;
+        worker.cTicks = 0;
+        worker.simulation.SetLayout(&layout);
+        worker.simulation.Initialize(_pTilesTexture, _pSpriteTexture, &worker.clock);
+        worker.simulation.SetTruePathing(fTruePathing);
+        worker.simulation.InitLevel();
+    }
+
+    // Every game starts from the same place
+    _pWorkers[0].simulation.Save(_pStartSnapshot);
+    return true;
+}
+
+bool RolloutFarm::Run(Uint32 cGames, Uint32 cMaxTicks, Policy policy, void *pContext, Result *pResults)
+{
+    SDL_assert(_pWorkers != nullptr);
+    _cMaxTicks = cMaxTicks;
+    _policy = (policy != nullptr) ? policy : WanderPolicy;
+    _pContext = pContext;
+    _stats = { _cWorkers, 0, 0, 0 };
+    Uint32 startTicks = SDL_GetTicks();
+
+    // Deal the games out evenly, stealing evens it up from there
+    for (Uint32 i = 0; i < _cWorkers; i++)
+    {
+        Worker &worker = _pWorkers[i];
+        worker.next = static_cast<Uint32>((static_cast<Uint64>(cGames) * i) / _cWorkers);
+        worker.end = static_cast<Uint32>((static_cast<Uint64>(cGames) * (i + 1)) / _cWorkers);
+        worker.pResults = nullptr;
+        worker.cResults = 0;
+        worker.cResultsMax = 0;
+        worker.cSteals = 0;
+        worker.cTicks = 0;
+    }
+
+    // Worker 0 is this thread
+    bool fResult = true;
+    for (Uint32 i = 1; i < _cWorkers; i++)
+    {
+        _pWorkers[i].pThread = SDL_CreateThread(WorkerThread, "RolloutWorker", &_pWorkers[i]);
+        if (_pWorkers[i].pThread == nullptr)
+        {
+            // The games left in its range just get stolen by everyone else
+            printf("RolloutFarm::Run() : SDL_CreateThread failed, error = %s\n", SDL_GetError());
+        }
+    }
+    WorkerThread(&_pWorkers[0]);
+
+    // Merge the per worker results back into game order
+    Uint32 cMerged = 0;
+    for (Uint32 i = 0; i < _cWorkers; i++)
+    {
+        Worker &worker = _pWorkers[i];
+        if (worker.pThread != nullptr)
+        {
+            SDL_WaitThread(worker.pThread, nullptr);
+            worker.pThread = nullptr;
+        }
+
+        for (Uint32 j = 0; j < worker.cResults; j++)
+        {
+            pResults[worker.pResults[j].iGame] = worker.pResults[j];
+        }
+        cMerged += worker.cResults;
+        _stats.cSteals += worker.cSteals;
+        _stats.cTicks += worker.cTicks;
+        delete[] worker.pResults;
+        worker.pResults = nullptr;
+    }
+    _stats.msElapsed = SDL_GetTicks() - startTicks;
+
+    if (cMerged != cGames)
+    {
+        printf("RolloutFarm::Run() : only %u of %u games were played\n", cMerged, cGames);
+        fResult = false;
+    }
+    return fResult;
+}
+
+int RolloutFarm::WorkerThread(void *pData)
+{
+    Worker &worker = *static_cast<Worker *>(pData);
+    RolloutFarm *pFarm = worker.pFarm;
+    Uint32 iWorker = static_cast<Uint32>(&worker - pFarm->_pWorkers);
+
+    Uint32 iGame = 0;
+    while (pFarm->TakeGame(iWorker, &iGame))
+    {
+        pFarm->PlayGame(worker, iGame);
+    }
+    return 0;
+}
+
+// Next game from our own range, or failing that from someone else's
+bool RolloutFarm::TakeGame(Uint32 iWorker, Uint32 *piGame)
+{
+    Worker &worker = _pWorkers[iWorker];
+    do
+    {
+        bool fTaken = false;
+        SDL_AtomicLock(&worker.lock);
+        if (worker.next < worker.end)
+        {
+            *piGame = worker.next++;
+            fTaken = true;
+        }
+        SDL_AtomicUnlock(&worker.lock);
+
+        if (fTaken)
+        {
+            return true;
+        }
+    } while (StealGames(iWorker));
+    return false;
+}
+
+// Take the back half of the first range we find with anything left in it.  Only one lock is held
+// at a time, our own range is empty so nobody else will be stealing from it meanwhile
+bool RolloutFarm::StealGames(Uint32 iWorker)
+{
+    for (Uint32 i = 1; i < _cWorkers; i++)
+    {
+        Worker &victim = _pWorkers[(iWorker + i) % _cWorkers];
+        Uint32 first = 0;
+        Uint32 end = 0;
+
+        SDL_AtomicLock(&victim.lock);
+        if (victim.next < victim.end)
+        {
+            end = victim.end;
+            first = victim.end - ((victim.end - victim.next + 1) / 2);
+            victim.end = first;
+        }
+        SDL_AtomicUnlock(&victim.lock);
+
+        if (first < end)
+        {
+            Worker &worker = _pWorkers[iWorker];
+            SDL_AtomicLock(&worker.lock);
+            worker.next = first;
+            worker.end = end;
+            SDL_AtomicUnlock(&worker.lock);
+            worker.cSteals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void RolloutFarm::PlayGame(Worker &worker, Uint32 iGame)
+{
+    if (worker.cResults == worker.cResultsMax)
+    {
+        // Nobody knows up front how many games a worker will end up with, grow as needed
+        Uint32 cResultsMax = SDL_max(worker.cResultsMax * 2, 64u);
+        Result *pResults = new Result[cResultsMax];
+        if (worker.cResults != 0)
+        {
+            SDL_memcpy(pResults, worker.pResults, worker.cResults * sizeof(Result));
+        }
+        delete[] worker.pResults;
+        worker.pResults = pResults;
+        worker.cResultsMax = cResultsMax;
+    }
+
+    Result &result = worker.pResults[worker.cResults++];
+    result = { iGame, 0, 0, 0, false, false };
+
+    worker.simulation.Restore(*_pStartSnapshot);
+    while (((_cMaxTicks == 0) || (result.cTicks < _cMaxTicks)) && !result.fCaught && !result.fCleared)
+    {
+        Direction inputDirection = _policy(worker.simulation, iGame, result.cTicks, _pContext);
+        worker.clock.Tick();
+        Simulation::StepResult step = worker.simulation.Step(inputDirection);
+        result.cTicks++;
+
+        if (step.cPelletsEaten != 0)
+        {
+            result.cPelletsEaten += step.cPelletsEaten;
+            result.score += step.fPowerPellet ? Constants::PowerPelletPoints : Constants::PelletPoints;
+        }
+        result.fCaught = step.fPlayerCaught;
+        result.fCleared = step.fLevelComplete;
+    }
+    worker.cTicks += result.cTicks;
+}
+
+Direction RolloutFarm::WanderPolicy(Simulation & /*simulation*/, Uint32 iGame, Uint32 tick, void * /*pContext*/)
+{
+    static const Uint32 c_ticksPerChoice = 30;
+
+    // Cheap integer hash of (game, choice) so each game has its own repeatable wander
+    Uint32 hash = (iGame * 0x9E3779B1u) ^ ((tick / c_ticksPerChoice) * 0x85EBCA77u);
+    hash ^= hash >> 15;
+    hash *= 0x2C1B3C6Du;
+    hash ^= hash >> 12;
+    return static_cast<Direction>(hash % 5);
+}
@@ -0,0 +1,316 @@
+#include "include/simulation.h"
+
+using namespace XplatGameTutorial::PacManClone;
+
+// TEMP compile time flags for ghost enabling
+#define GHOST_BLINKY
+#define GHOST_PINKY
+#define GHOST_INKY
+#define GHOST_CLYDE
+
+// requires Blinky so make sure we enabled it
+// will crash otherwise
+#ifdef GHOST_INKY
+#ifndef GHOST_BLINKY
+#define GHOST_BLINKY
+#endif
+#endif
+
+// Duplicated code based on class type - perfect for a template function
+// This creates an object if it does not already exist, and in all cases
+// will Reset() the object
+template <class T> void InitGameSprite(T** p, TextureWrapper* pTexture, Maze* pMaze)
+{
+    if (*p == nullptr)
+    {
+        *p = new T(pTexture);
+        (*p)->Initialize();
+    }
+    (*p)->Reset(pMaze);
+}
+
+void Simulation::Cleanup()
+{
+    SafeDelete<Maze>(_pMaze);
+    SafeDelete<Player>(_pPlayer);
+    SafeDelete<Blinky>(_pBlinky);
+    SafeDelete<Pinky>(_pPinky);
+    SafeDelete<Inky>(_pInky);
+    SafeDelete<Clyde>(_pClyde);
+
+    // The _pGhosts array just holds references to deleted
+    // objects, clear them
+    for (size_t i = 0; i < SDL_arraysize(_pGhosts); i++)
+    {
+        _pGhosts[i] = nullptr;
+    }
+}
+
+void Simulation::InitLevel()
+{
+    SDL_assert((_pTilesTexture != nullptr) && (_pSpriteTexture != nullptr) && (_pClock != nullptr));
+
+    // This should be know, but it should also match what we just queried
+    SDL_assert(_pTilesTexture->Width() == Constants::TileTextureWidth);
+    SDL_assert(_pTilesTexture->Height() == Constants::TileTextureHeight);
+    SDL_Rect textureRect{ 0, 0, Constants::TileTextureWidth, Constants::TileTextureHeight };
+
+    // Initialize our tiled map object
+    if (_pMaze == nullptr)
+    {
+        _pMaze = new Maze(*_pLayout, Constants::ScreenWidth, Constants::ScreenHeight);
+
+        _pMaze->Initialize(textureRect, { 0, 0,  Constants::TileWidth,  Constants::TileHeight }, _pTilesTexture->Ptr());
+        SDL_assert(_pMaze->PelletsRemaining() == _pLayout->cPellets);
+    }
+    else
+    {
+        _pMaze->ResetPellets();
+    }
+
+    if (_fTruePathing)
+    {
+        _pMaze->BuildPathTable();
+    }
+
+    InitializeSprites();
+
+    if (_cCrowdGhosts != 0)
+    {
+        if (_crowd.Capacity() == 0)
+        {
+            _crowd.Initialize(_cCrowdGhosts, _pClock);
+        }
+        _crowd.SetTruePathing(_fTruePathing);
+        _crowd.Reset(_pMaze, _cCrowdGhosts);
+    }
+
+    // So the blackboard describes the new level before the first Step()
+    UpdateBlackboard();
+}
+
+void Simulation::InitializeSprites()
+{
+    // In all cases we create a player
+    InitGameSprite(&_pPlayer, _pSpriteTexture, _pMaze);
+
+    // The ghosts are controlled by these flags
+#ifdef GHOST_BLINKY
+    InitGameSprite(&_pBlinky, _pSpriteTexture, _pMaze);
+    _pGhosts[0] = _pBlinky;
+#endif
+
+#ifdef GHOST_PINKY
+    InitGameSprite(&_pPinky, _pSpriteTexture, _pMaze);
+    _pGhosts[1] = _pPinky;
+#endif
+
+    // Will also enable blinky as he is needed for Inky's
+    // targeting scheme
+#ifdef GHOST_INKY
+    InitGameSprite(&_pInky, _pSpriteTexture, _pMaze);
+    _pInky->SetPartner(_pBlinky);
+    _pGhosts[2] = _pInky;
+#endif
+
+#ifdef GHOST_CLYDE
+    InitGameSprite(&_pClyde, _pSpriteTexture, _pMaze);
+    _pGhosts[3] = _pClyde;
+#endif
+
+    // Ghost timers run on simulation time, not the wall clock
+    for (size_t i = 0; i < SDL_arraysize(_pGhosts); i++)
+    {
+        if (_pGhosts[i] != nullptr)
+        {
+            _pGhosts[i]->SetClock(_pClock);
+            _pGhosts[i]->SetSlot(i);
+            _pGhosts[i]->SetTruePathing(_fTruePathing);
+        }
+    }
+}
+
+template <class T> void Simulation::UpdateGhost(T *pGhost, size_t iSlot)
+{
+    SDL_assert(_pGhosts[iSlot] == pGhost);
+    if (pGhost != nullptr)
+    {
+        {
+            Profiler::Scope scope(_pProfiler, static_cast<Profiler::Phase>(static_cast<int>(Profiler::Phase::GhostUpdate) + iSlot));
+            pGhost->Update(_blackboard, _pMaze);
+        }
+
+        // Ghosts later in the array see where this one moved to, same as before the blackboard
+        UpdateBlackboardGhost(iSlot);
+    }
+}
+
+// Move the player, eat what they land on, then let each ghost move and decide
+Simulation::StepResult Simulation::Step(Direction inputDirection)
+{
+    StepResult result = { 0, false, false, false };
+    {
+        Profiler::Scope scope(_pProfiler, Profiler::Phase::PlayerUpdate);
+        _pPlayer->Update(_pMaze, inputDirection);
+    }
+    {
+        Profiler::Scope scope(_pProfiler, Profiler::Phase::PelletCollision);
+        result.cPelletsEaten = HandlePelletCollision(&result.fPowerPellet);
+    }
+    UpdateBlackboard();
+
+    // Through the typed pointers so each ghost runs its own copy of Update with its targeting
+    // inlined, in slot order
+    UpdateGhost(_pBlinky, 0);
+    UpdateGhost(_pPinky, 1);
+    UpdateGhost(_pInky, 2);
+    UpdateGhost(_pClyde, 3);
+    if (_cCrowdGhosts != 0)
+    {
+        Profiler::Scope scope(_pProfiler, Profiler::Phase::CrowdUpdate);
+        _crowd.Update(_blackboard, _pMaze);
+    }
+    result.fPlayerCaught = HandleGhostCollision();
+    result.fLevelComplete = (result.cPelletsEaten != 0) && (_pMaze->PelletsRemaining() == 0);
+    return result;
+}
+
+// Field by field into the flat snapshot, nothing here allocates
+void Simulation::Save(GameSnapshot *pSnapshot)
+{
+    SDL_assert((_pMaze != nullptr) && (_pPlayer != nullptr));
+    SDL_assert(_pMaze->TileCount() <= PelletBoard::c_cBits);
+    SDL_assert(_cCrowdGhosts == 0);
+
+    pSnapshot->clockTicks = _pClock->Ticks();
+    pSnapshot->blackboard = _blackboard;
+    _pPlayer->Save(&pSnapshot->player);
+    for (size_t i = 0; i < SDL_arraysize(_pGhosts); i++)
+    {
+        if (_pGhosts[i] != nullptr)
+        {
+            _pGhosts[i]->Save(&pSnapshot->ghosts[i]);
+        }
+    }
+    _pMaze->SavePellets(&pSnapshot->pellets, &pSnapshot->powerPellets);
+}
+
+void Simulation::Restore(const GameSnapshot &snapshot)
+{
+    SDL_assert((_pMaze != nullptr) && (_pPlayer != nullptr));
+    SDL_assert(_pMaze->TileCount() <= PelletBoard::c_cBits);
+
+    _pClock->SetTicks(snapshot.clockTicks);
+    _blackboard = snapshot.blackboard;
+    _pPlayer->Restore(snapshot.player);
+    for (size_t i = 0; i < SDL_arraysize(_pGhosts); i++)
+    {
+        if (_pGhosts[i] != nullptr)
+        {
+            _pGhosts[i]->Restore(snapshot.ghosts[i]);
+        }
+    }
+    _pMaze->RestorePellets(snapshot.pellets, snapshot.powerPellets);
+}
+
+// Detect if the player has entered a pellet tile and remove it, returning how many were eaten.
+// A power pellet sends every ghost into scatter
+Uint16 Simulation::HandlePelletCollision(bool *pfPowerPellet)
+{
+    Uint16 ret = 0;
+    *pfPowerPellet = false;
+    SDL_Point playerPoint = { _pPlayer->X(), _pPlayer->Y() };
+    Uint16 row = 0;
+    Uint16 col = 0;
+    _pMaze->GetTileRowCol(playerPoint, row, col);
+
+    if (_pMaze->IsTilePellet(row, col))
+    {
+        _pMaze->EatPellet(row, col);
+        ret++;
+    }
+    else if (_pMaze->IsTilePowerPellet(row, col))
+    {
+        _pMaze->EatPellet(row, col);
+        ret++;
+        *pfPowerPellet = true;
+
+        for (size_t i = 0; i < SDL_arraysize(_pGhosts); i++)
+        {
+            if (_pGhosts[i] != nullptr)
+            {
+                _pGhosts[i]->OnPowerPelletEaten(_pMaze);
+            }
+        }
+        if (_cCrowdGhosts != 0)
+        {
+            _crowd.OnPowerPelletEaten(_pMaze);
+        }
+    }
+    return ret;
+}
+
+// Detect if the player has collided with a ghost (i.e. they are in the
+// same cell during the same frame) and handle it based on state (whether
+// the player has an active power pellet)
+bool Simulation::HandleGhostCollision()
+{
+    Profiler::Scope scope(_pProfiler, Profiler::Phase::GhostCollision);
+    bool fCaught = false;
+
+    SDL_Point playerPoint = { _pPlayer->X(), _pPlayer->Y() };
+    Uint16 row = 0;
+    Uint16 col = 0;
+    _pMaze->GetTileRowCol(playerPoint, row, col);
+    for (size_t i = 0; i < SDL_arraysize(_pGhosts); i++)
+    {
+        if (_pGhosts[i] != nullptr)
+        {
+            SDL_Point ghostPoint = { _pGhosts[i]->X(), _pGhosts[i]->Y() };
+            Uint16 ghostRow = 0;
+            Uint16 ghostCol = 0;
+            _pMaze->GetTileRowCol(ghostPoint, ghostRow, ghostCol);
+
+            if (ghostRow == row && ghostCol == col)
+            {
+                if (_pGhosts[i]->OnPlayerCollision())
+                {
+                    fCaught = true;
+                }
+            }
+        }
+    }
+
+    if ((_cCrowdGhosts != 0) && _crowd.IsChasingOn(row, col))
+    {
+        fCaught = true;
+    }
+    return fCaught;
+}
+
+// Work out what the ghosts need to know once per tick, rather than once per ghost decision
+void Simulation::UpdateBlackboard()
+{
+    SDL_Point playerPoint = { _pPlayer->X(), _pPlayer->Y() };
+    _blackboard.playerX = _pPlayer->FixedX();
+    _pMaze->GetTileRowCol(playerPoint, _blackboard.playerRow, _blackboard.playerCol);
+    _blackboard.playerFacing = _pPlayer->Facing();
+    _pPlayer->GetTilePlayerFacingWithOriginalBug(_pMaze, 2, _blackboard.twoAheadRow, _blackboard.twoAheadCol);
+    _pPlayer->GetTilePlayerFacingWithOriginalBug(_pMaze, 4, _blackboard.fourAheadRow, _blackboard.fourAheadCol);
+
+    for (size_t i = 0; i < SDL_arraysize(_pGhosts); i++)
+    {
+        if (_pGhosts[i] != nullptr)
+        {
+            UpdateBlackboardGhost(i);
+        }
+    }
+}
+
+void Simulation::UpdateBlackboardGhost(size_t ghostIndex)
+{
+    Blackboard::GhostInfo &info = _blackboard.ghosts[ghostIndex];
+    SDL_Point ghostPoint = { _pGhosts[ghostIndex]->X(), _pGhosts[ghostIndex]->Y() };
+    _pMaze->GetTileRowCol(ghostPoint, info.row, info.col);
+    info.fScatter = _pGhosts[ghostIndex]->IsScattering();
+}
@@ -4,10 +4,10 @@
 using namespace XplatGameTutorial::PacManClone;
 
 Sprite::Sprite(TextureWrapper *pTextureWrapper, Uint16 cxFrame, Uint16 cyFrame, Uint16 cFramesTotal, Uint16 cAnimationsTotal) :
-    _x(0.0),
-    _y(0.0),
-    _dx(0.0),
-    _dy(0.0),
+    _x(0),
+    _y(0),
+    _dx(0),
+    _dy(0),
     _cFramesTotal(cFramesTotal),
     _pFrames(nullptr),
     _cxFrame(cxFrame),
@@ -41,8 +41,9 @@ Sprite::~Sprite()
 // Loads a single frame at the given coordinates on the texture to the specifed index
 bool Sprite::LoadFrame(Uint16 frameIndex, Uint16 xTexture, Uint16 yTexture)
 {
-    // We've made several assumption in the implementation, so validate them
-    SDL_assert((_pTextureWrapper != nullptr) && (!_pTextureWrapper->IsNull()));
+    // We've made several assumption in the implementation, so validate them.  The texture itself
+    // may be null when running headless, but its size is still known
+    SDL_assert(_pTextureWrapper != nullptr);
     SDL_assert(_cxFrame > 0);
     SDL_assert(_cyFrame > 0);
     SDL_assert(_cFramesTotal > 0);
@@ -99,7 +100,7 @@ bool Sprite::LoadFrames(Uint16 frameIndexStart, Uint16 xTextureStart, Uint16 yTe
 }
 
 //  Store the given animation sequence at the specified index.  This is mostly delegated to the SpriteAnimation helper class
-void Sprite::LoadAnimationSequence(Uint16 index, AnimationType animationType, int* pSequence, Uint16 cFramesInSequence, Uint16 animationSpeed)
+void Sprite::LoadAnimationSequence(Uint16 index, AnimationType animationType, const int* pSequence, Uint16 cFramesInSequence, Uint16 animationSpeed)
 {
     // First time allocate the space for the animation helpers
     if (_ppSpriteAnimations == nullptr)
@@ -132,7 +133,7 @@ void Sprite::SetAnimation(Uint16 index)
 }
 
 // Store a new velocity
-void Sprite::SetVelocity(double dx, double dy)
+void Sprite::SetVelocity(Fixed dx, Fixed dy)
 {
     _dx = dx;
     _dy = dy;
@@ -140,10 +141,10 @@ void Sprite::SetVelocity(double dx, double dy)
 
 // Manually set a position, normal play position is Update()d but we also
 // need the ability to place it directly
-void Sprite::ResetPosition(double x, double y)
+void Sprite::ResetPosition(int x, int y)
 {
-    _x = x;
-    _y = y;
+    _x = ToFixed(x);
+    _y = ToFixed(y);
 }
 
 // Manually set frame index for non-animated sprites
@@ -175,6 +176,37 @@ void Sprite::SetVisible(SDL_bool visible)
     _fVisible = visible;
 }
 
+void Sprite::Save(Snapshot *pSnapshot)
+{
+    pSnapshot->x = _x;
+    pSnapshot->y = _y;
+    pSnapshot->dx = _dx;
+    pSnapshot->dy = _dy;
+    pSnapshot->animationIndex = _currentAnimationIndex;
+    pSnapshot->animationFrame = 0;
+    pSnapshot->animationCounter = 0;
+    if (_ppSpriteAnimations != nullptr)
+    {
+        pSnapshot->animationFrame = _ppSpriteAnimations[_currentAnimationIndex]->FrameIndex();
+        pSnapshot->animationCounter = _ppSpriteAnimations[_currentAnimationIndex]->Counter();
+    }
+    pSnapshot->fVisible = _fVisible;
+}
+
+void Sprite::Restore(const Snapshot &snapshot)
+{
+    _x = snapshot.x;
+    _y = snapshot.y;
+    _dx = snapshot.dx;
+    _dy = snapshot.dy;
+    _currentAnimationIndex = snapshot.animationIndex;
+    if (_ppSpriteAnimations != nullptr)
+    {
+        _ppSpriteAnimations[_currentAnimationIndex]->SetProgress(snapshot.animationFrame, snapshot.animationCounter);
+    }
+    _fVisible = snapshot.fVisible;
+}
+
 // set new positio based on velocity and update the current animation
 void Sprite::Update()
 {
@@ -187,15 +219,17 @@ void Sprite::Update()
 
 // Very similar to the tilemap, only in this case, we're index the frame
 // to draw based on the current animation state (or static frame) instead
-// on a static indexed map of tiles
-void Sprite::Render(SDL_Renderer *pSDLRenderer)
+// on a static indexed map of tiles.  Sprites entirely outside the view are skipped
+void Sprite::RenderAt(SDL_Renderer *pSDLRenderer, int x, int y, const SDL_Rect &view)
 {
-    if (_fVisible == SDL_TRUE)
+    SDL_Rect targetRect{ x + _cxFrameOffset, y + _cyFrameOffset, _cxFrame, _cyFrame };
+    if ((_fVisible == SDL_TRUE) && !_pTextureWrapper->IsNull() && (SDL_HasIntersection(&targetRect, &view) == SDL_TRUE))
     {
         // Find the index to the current frame in the current animation and draw it to the renderer
-        // at the correct x,y delta offset
+        // at the correct x,y delta offset, moved from the map onto the screen
         int frameIndex = (_ppSpriteAnimations == nullptr) ? _staticFrameIndex : _ppSpriteAnimations[_currentAnimationIndex]->CurrentFrame();
-        SDL_Rect targetRect{ static_cast<int>(_x) + _cxFrameOffset, static_cast<int>(_y) + _cyFrameOffset, _cxFrame, _cyFrame };
+        targetRect.x -= view.x;
+        targetRect.y -= view.y;
         SDL_RenderCopy(
             pSDLRenderer,
             _pTextureWrapper->Ptr(),
@@ -229,12 +263,13 @@ Direction Sprite::CurrentDirection()
 
 bool Sprite::IsOutOfView(SDL_Rect &rect)
 {
+    // In fixed point, so being part way into the last pixel doesn't count as out
     bool result = false;
-    if (X() > rect.x + rect.w + Width())
+    if (_x > ToFixed(rect.x + rect.w + Width()))
     {
         result = true;
     }
-    else if (X() < rect.x - Width())
+    else if (_x < ToFixed(rect.x - Width()))
     {
         result = true;
     }
@@ -1,27 +1,31 @@
 #include "include/tiledmap.h"
+#include <stdio.h>
 
 using namespace XplatGameTutorial::PacManClone;
 
 // The main goals here are to 
 // 1) Divide up the texture into src rects
-// 2) Copy the index data
+// 2) Hand the index data to the tile store
 // 3) Cache some calculated values we'll reuse rendering
 bool TiledMap::Initialize(
     SDL_Rect textureRect,           // Size of the texture
     SDL_Rect tileRect,              // size of the tile - the texture should be a multiple of this size...
     SDL_Texture *pTexture,          // texture holding the tiles
-    Uint16 *pMapIndices,            // array of indicies to the tiles, should match in size to map
-    Uint16 countOfIndicies)         // again should match, but here to be explicit in the code
+    const Uint16 *pMapIndices,      // array of indicies to the tiles, should match in size to map
+    size_t countOfIndicies,         // again should match, but here to be explicit in the code
+    size_t cbTileBudget,            // how much of the above to keep in memory
+    const Uint64 *pChangeable,      // bitboards of the tiles SetTileIndexAt can change, can be null
+    size_t cChangeableLayers)       // ...and how many of them
 {
     // Validate some assumptions
     SDL_assert((textureRect.w % tileRect.w) == 0);
     SDL_assert((textureRect.h % tileRect.h) == 0);
-    SDL_assert(countOfIndicies == (_cRows * _cCols));
+    SDL_assert(countOfIndicies == (static_cast<size_t>(_cRows) * _cCols));
     SDL_assert(pMapIndices != nullptr);
+    SDL_assert((_cCols * tileRect.w <= 0xFFFF) && (_cRows * tileRect.h <= 0xFFFF));
 
-    // Copy the map indicies data
-    _pMapIndicies = new Uint16[countOfIndicies] { };
-    SDL_memcpy(_pMapIndicies, pMapIndices, countOfIndicies * sizeof(Uint16));
+    // The indices are read in as they're needed
+    _tiles.Initialize(pMapIndices, _cRows, _cCols, cbTileBudget, pChangeable, cChangeableLayers);
 
     // Copy the texture data
     _pTileTexture = pTexture;
@@ -35,11 +39,11 @@ bool TiledMap::Initialize(
     _cTilesOnTexture = static_cast<Uint16>(((_textureRect.w / _tileSize) * textureTilesPerHeight));
     _pTileRects = new SDL_Rect[_cTilesOnTexture] {};
     
-    // Center the map, so calculate the offsets
+    // Center the map, so calculate the offsets.  One bigger than the screen starts at the corner
     _cxWidth = (_cCols * _tileSize);
     _cyHeight = (_cRows * _tileSize);
-    _cxOffset = (_cxScreen - _cxWidth) / 2;
-    _cyOffset = (_cyScreen - _cyHeight) / 2;
+    _cxOffset = (_cxScreen > _cxWidth) ? (_cxScreen - _cxWidth) / 2 : 0;
+    _cyOffset = (_cyScreen > _cyHeight) ? (_cyScreen - _cyHeight) / 2 : 0;
 
     if (_pTileRects != nullptr)
     {
@@ -58,30 +62,150 @@ bool TiledMap::Initialize(
     return true;
 }
 
-// Loop through the map of indicies and render each tile in order.  Center the map on the screen
-void TiledMap::Render(SDL_Renderer *pSDLRenderer)
+// Draws a single tile from the map relative to the given origin
+void TiledMap::RenderTile(SDL_Renderer *pSDLRenderer, Uint16 row, Uint16 col, int xOrigin, int yOrigin)
 {
-    SDL_assert(_cRows * _pTileRects[0].w <= _cxScreen); // Every tile is the same size in this implementation
-    SDL_assert(_cCols * _pTileRects[0].h <= _cyScreen);
+    SDL_Rect targetRect = { (col * _tileSize) + xOrigin, (row * _tileSize) + yOrigin, _tileSize, _tileSize };
+    int currentTileIndex = GetTileIndexAt(row, col);
+
+    SDL_RenderCopy(
+        pSDLRenderer,                   // Our renderer - everything goes here that draws
+        _pTileTexture,                  // texture that holds the source tiles
+        &_pTileRects[currentTileIndex], // rect in our map indicies list that tells us which tile to draw
+        &targetRect);                   // dest rect on the screen for the tile indexed above
+}
 
-    SDL_Rect targetRect = {0, 0, _tileSize, _tileSize }; // The size won't change, so we'll update the x, y
-    for (int r = 0; r < _cRows; r++)
+// Loop through the map of indicies and render each tile in the block in order relative to the given origin
+void TiledMap::RenderTiles(SDL_Renderer *pSDLRenderer, SDL_Rect &tiles, int xOrigin, int yOrigin)
+{
+    for (int r = tiles.y; r < tiles.y + tiles.h; r++)
     {
-        for (int c = 0; c < _cCols; c++) 
+        for (int c = tiles.x; c < tiles.x + tiles.w; c++)
         {
-            targetRect.x = (c * _tileSize) + _cxOffset;
-            targetRect.y = (r * _tileSize) + _cyOffset;
-            int currentTileIndex = _pMapIndicies[r * _cCols + c];
-
-            SDL_RenderCopy(
-                pSDLRenderer,                   // Our renderer - everything goes here that draws
-                _pTileTexture,                  // texture that holds the source tiles
-                &_pTileRects[currentTileIndex], // rect in our map indicies list that tells us which tile to draw
-                &targetRect);                   // dest rect on the screen for the tile indexed above
+            RenderTile(pSDLRenderer, static_cast<Uint16>(r), static_cast<Uint16>(c), xOrigin, yOrigin);
         }
     }
 }
 
+// Partly visible tiles count, so round the far edge up
+SDL_Rect TiledMap::VisibleTiles()
+{
+    int left = SDL_max(_view.x - _cxOffset, 0);
+    int top = SDL_max(_view.y - _cyOffset, 0);
+    int right = SDL_min(_view.x + _view.w - _cxOffset, static_cast<int>(_cxWidth));
+    int bottom = SDL_min(_view.y + _view.h - _cyOffset, static_cast<int>(_cyHeight));
+    if ((right <= left) || (bottom <= top))
+    {
+        return { 0, 0, 0, 0 };
+    }
+
+    int col = left / _tileSize;
+    int row = top / _tileSize;
+    return { col, row, ((right + _tileSize - 1) / _tileSize) - col, ((bottom + _tileSize - 1) / _tileSize) - row };
+}
+
+void TiledMap::CenterViewOn(int x, int y)
+{
+    // The offsets are 0 whenever the map is bigger than the window
+    if (_cxWidth > _cxScreen)
+    {
+        _view.x = SDL_max(SDL_min(x - (_cxScreen / 2), _cxWidth - _cxScreen), 0);
+    }
+    if (_cyHeight > _cyScreen)
+    {
+        _view.y = SDL_max(SDL_min(y - (_cyScreen / 2), _cyHeight - _cyScreen), 0);
+    }
+}
+
+// Creates the render target the size of the whole map and draws every tile into it.  If the renderer
+// can't do render targets we return false and Render() falls back to drawing tile by tile
+bool TiledMap::BakeCache(SDL_Renderer *pSDLRenderer)
+{
+    if ((_cxWidth > c_maxCacheSide) || (_cyHeight > c_maxCacheSide))
+    {
+        // Drawing the whole thing would read in every tile, and it wouldn't fit on most GPUs anyway
+        _fCacheUnsupported = true;
+        return false;
+    }
+
+    if (_pCacheTexture == nullptr)
+    {
+        _pCacheTexture = SDL_CreateTexture(pSDLRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _cxWidth, _cyHeight);
+        if (_pCacheTexture == nullptr)
+        {
+            printf("SDL_CreateTexture() failed, error = %s\n", SDL_GetError());
+            _fCacheUnsupported = true;
+            return false;
+        }
+    }
+    _fCacheValid = false;
+    UpdateCache(pSDLRenderer);
+    return true;
+}
+
+// Bring the cache up to date - everything if it's invalid, otherwise just the dirty tiles.  The tiles
+// are opaque so drawing a new one straight over the old one is enough
+void TiledMap::UpdateCache(SDL_Renderer *pSDLRenderer)
+{
+    if (_fCacheValid && (_cDirtyTiles == 0))
+    {
+        return;
+    }
+
+    SDL_Texture *pPreviousTarget = SDL_GetRenderTarget(pSDLRenderer);
+    if (SDL_SetRenderTarget(pSDLRenderer, _pCacheTexture) != 0)
+    {
+        printf("SDL_SetRenderTarget() failed, error = %s\n", SDL_GetError());
+        return;
+    }
+
+    if (!_fCacheValid)
+    {
+        SDL_Rect tiles = { 0, 0, _cCols, _cRows };
+        RenderTiles(pSDLRenderer, tiles, 0, 0);
+        _fCacheValid = true;
+    }
+    else
+    {
+        for (Uint16 i = 0; i < _cDirtyTiles; i++)
+        {
+            RenderTile(pSDLRenderer, _dirtyTiles[i].row, _dirtyTiles[i].col, 0, 0);
+        }
+    }
+    _cDirtyTiles = 0;
+
+    SDL_SetRenderTarget(pSDLRenderer, pPreviousTarget);
+}
+
+// Present the part of the cached map in view, patching in any tiles that changed first
+void TiledMap::Render(SDL_Renderer *pSDLRenderer)
+{
+    int xOrigin = _cxOffset - _view.x;
+    int yOrigin = _cyOffset - _view.y;
+    if (_fCacheUnsupported || ((_pCacheTexture == nullptr) && !BakeCache(pSDLRenderer)))
+    {
+        // No render target support (or the map is too big for one), draw the tiles in view straight
+        // to the screen
+        SDL_Rect tiles = VisibleTiles();
+        SDL_SetTextureColorMod(_pTileTexture, _colorMod.r, _colorMod.g, _colorMod.b);
+        RenderTiles(pSDLRenderer, tiles, xOrigin, yOrigin);
+        return;
+    }
+
+    UpdateCache(pSDLRenderer);
+
+    // The cache is in map pixels, with the map's corner at 0,0
+    SDL_Rect mapRect = { 0, 0, _cxWidth, _cyHeight };
+    SDL_Rect viewRect = { _view.x - _cxOffset, _view.y - _cyOffset, _view.w, _view.h };
+    SDL_Rect sourceRect;
+    if (SDL_IntersectRect(&mapRect, &viewRect, &sourceRect) == SDL_TRUE)
+    {
+        SDL_Rect targetRect = { sourceRect.x + xOrigin, sourceRect.y + yOrigin, sourceRect.w, sourceRect.h };
+        SDL_SetTextureColorMod(_pCacheTexture, _colorMod.r, _colorMod.g, _colorMod.b);
+        SDL_RenderCopy(pSDLRenderer, _pCacheTexture, &sourceRect, &targetRect);
+    }
+}
+
 // returns the "center" pixel of the tile in 2D space - this helps with the sprite logic
 SDL_Point TiledMap::GetTileCoordinates(Uint16 row, Uint16 col)
 {
@@ -109,5 +233,14 @@ bool TiledMap::GetTileRowCol(SDL_Point &point, Uint16 &row, Uint16 &col)
 // Return the bounding rect of the entire map
 SDL_Rect TiledMap::GetMapBounds()
 {
-    return{ (_cxScreen - (_cCols * _tileSize)) / 2, (_cyScreen - _cyHeight) / 2, (_cCols * _tileSize), (_cRows * _tileSize) };
+    return{ _cxOffset, _cyOffset, _cxWidth, _cyHeight };
+}
+
+SDL_Rect TiledMap::GetScreenBounds()
+{
+    SDL_Rect screenRect = { 0, 0, _cxScreen, _cyScreen };
+    SDL_Rect mapRect = { _cxOffset - _view.x, _cyOffset - _view.y, _cxWidth, _cyHeight };
+    SDL_Rect result = { 0, 0, 0, 0 };
+    SDL_IntersectRect(&screenRect, &mapRect, &result);
+    return result;
 }
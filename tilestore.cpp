@@ -0,0 +1,148 @@
+#include "include/tilestore.h"
+#include "include/pelletboard.h"
+
+using namespace XplatGameTutorial::PacManClone;
+
+TileStore::~TileStore()
+{
+    Cleanup();
+}
+
+void TileStore::Initialize(const Uint16 *pSource, Uint16 rows, Uint16 cols, size_t cbBudget,
+    const Uint64 *pChangeable, size_t cChangeableLayers)
+{
+    SDL_assert(pSource != nullptr);
+    Cleanup();
+
+    _pSource = pSource;
+    _cRows = rows;
+    _cCols = cols;
+    _cChunkCols = (static_cast<size_t>(cols) + c_chunkSide - 1) >> c_chunkShift;
+    size_t cChunkRows = (static_cast<size_t>(rows) + c_chunkSide - 1) >> c_chunkShift;
+    size_t cChunksInMap = cChunkRows * _cChunkCols;
+    _pResident = new Uint32[cChunksInMap] { };
+
+    // Every chunk that can be changed plus one to read the rest through, but no more than the map
+    // has and always at least one
+    size_t cChangeable = (pChangeable != nullptr) ? CountChangeableChunks(pChangeable, cChangeableLayers) : 0;
+    _cPool = SDL_max(cbBudget / sizeof(Chunk), cChangeable + 1);
+    _cPool = SDL_max(SDL_min(_cPool, cChunksInMap), static_cast<size_t>(1));
+    _pPool = new Chunk[_cPool];
+}
+
+void TileStore::Cleanup()
+{
+    delete[] _pPool;
+    delete[] _pResident;
+    _pPool = nullptr;
+    _pResident = nullptr;
+    _cPool = 0;
+    _cChunks = 0;
+    _iClock = 0;
+}
+
+// The resident table isn't in use yet, so it marks the chunks counted.  Only the first tile of
+// each chunk's run along a row is looked at, the rest of the run is in the same chunk
+size_t TileStore::CountChangeableChunks(const Uint64 *pChangeable, size_t cChangeableLayers)
+{
+    size_t cWords = PelletBoard::WordsFor(static_cast<size_t>(_cRows) * _cCols);
+    size_t cChangeable = 0;
+    for (size_t word = 0; word < cWords; word++)
+    {
+        Uint64 bits = 0;
+        for (size_t layer = 0; layer < cChangeableLayers; layer++)
+        {
+            bits |= pChangeable[(layer * cWords) + word];
+        }
+
+        while (bits != 0)
+        {
+            size_t tile = (word * 64) + PelletBoard::LowestBit(bits);
+            size_t row = tile / _cCols;
+            size_t col = tile % _cCols;
+            size_t iChunk = ((row >> c_chunkShift) * _cChunkCols) + (col >> c_chunkShift);
+            if (_pResident[iChunk] == 0)
+            {
+                _pResident[iChunk] = 1;
+                cChangeable++;
+            }
+
+            size_t colNext = SDL_min(((col >> c_chunkShift) + 1) << c_chunkShift, static_cast<size_t>(_cCols));
+            size_t bitNext = (tile - col + colNext) - (word * 64);
+            bits = (bitNext < 64) ? (bits & ~((static_cast<Uint64>(1) << bitNext) - 1)) : 0;
+        }
+    }
+
+    size_t cChunksInMap = ((static_cast<size_t>(_cRows) + c_chunkSide - 1) >> c_chunkShift) * _cChunkCols;
+    SDL_memset(_pResident, 0, cChunksInMap * sizeof(Uint32));
+    return cChangeable;
+}
+
+Uint32 TileStore::Load(size_t iChunk)
+{
+    size_t slot;
+    if (_cChunks < _cPool)
+    {
+        slot = _cChunks++;
+    }
+    else
+    {
+        // There's always an unchanged chunk to let go of unless a tile that wasn't said to be
+        // changeable was changed, then one change is lost
+        bool fEvicted = Evict(&slot);
+        SDL_assert(fEvicted);
+        if (!fEvicted)
+        {
+            slot = _iClock;
+            _pResident[_pPool[slot].iChunk] = 0;
+        }
+    }
+
+    // Chunks on the right and bottom edges hang off the map, the part that does is left empty
+    Chunk &chunk = _pPool[slot];
+    size_t rowFirst = (iChunk / _cChunkCols) << c_chunkShift;
+    size_t colFirst = (iChunk % _cChunkCols) << c_chunkShift;
+    size_t cRows = SDL_min(static_cast<size_t>(c_chunkSide), _cRows - rowFirst);
+    size_t cCols = SDL_min(static_cast<size_t>(c_chunkSide), _cCols - colFirst);
+    if ((cRows < c_chunkSide) || (cCols < c_chunkSide))
+    {
+        SDL_memset(chunk.tiles, 0, sizeof(chunk.tiles));
+    }
+    for (size_t row = 0; row < cRows; row++)
+    {
+        SDL_memcpy(&chunk.tiles[row << c_chunkShift], &_pSource[((rowFirst + row) * _cCols) + colFirst], cCols * sizeof(Uint16));
+    }
+    chunk.iChunk = iChunk;
+    chunk.fReferenced = false;
+    chunk.fChanged = false;
+
+    _pResident[iChunk] = static_cast<Uint32>(slot + 1);
+    return _pResident[iChunk];
+}
+
+// Go round the chunks clearing the referenced flags until we come to one that's still clear.  Two
+// laps is enough to find one if there's any we can evict
+bool TileStore::Evict(size_t *pSlot)
+{
+    for (size_t step = 0; step < 2 * _cChunks; step++)
+    {
+        size_t slot = _iClock;
+        _iClock = (_iClock + 1) % _cChunks;
+
+        Chunk &chunk = _pPool[slot];
+        if (chunk.fChanged)
+        {
+            continue;
+        }
+        if (chunk.fReferenced)
+        {
+            chunk.fReferenced = false;
+            continue;
+        }
+
+        _pResident[chunk.iChunk] = 0;
+        *pSlot = slot;
+        return true;
+    }
+    return false;
+}
@@ -2,6 +2,80 @@
 #include "include/utils.h"
 #include "SDL_image.h"
 #include <stdio.h>
+#include <new>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifndef NDEBUG
+// Counting replacements for the global allocation functions (debug only).  Everything still
+// ends up in malloc/free, we just keep a tally of how many allocations were made.  The whole set
+// is replaced, nothrow and sized forms included, so nothing gets past the count and whatever a
+// toolchain pairs up always frees with what allocated it
+static SDL_atomic_t s_cHeapAllocations;
+
+void* operator new(size_t cb, const std::nothrow_t&) noexcept
+{
+    SDL_AtomicAdd(&s_cHeapAllocations, 1);
+    return SDL_malloc((cb != 0) ? cb : 1);
+}
+
+void* operator new(size_t cb)
+{
+    void *p = operator new(cb, std::nothrow);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t cb)
+{
+    return operator new(cb);
+}
+
+void* operator new[](size_t cb, const std::nothrow_t&) noexcept
+{
+    return operator new(cb, std::nothrow);
+}
+
+void operator delete(void *p) noexcept
+{
+    SDL_free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    SDL_free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t&) noexcept
+{
+    SDL_free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t&) noexcept
+{
+    SDL_free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    SDL_free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    SDL_free(p);
+}
+#endif
 
 namespace XplatGameTutorial
 {
@@ -102,23 +176,47 @@ namespace PacManClone
                         printf("SDL_SetRenderDrawColor() failed, error = %s\n", SDL_GetError());
                         fResult = false;
                     }
-                    else
-                    {
-                        // This bit will allow us to load PNG files, which I am storing all my images assets as
-                        const int cFlagsNeeded = IMG_INIT_PNG | IMG_INIT_JPG;
-                        int iFlagsInitted = IMG_Init(cFlagsNeeded);
-                        if ((iFlagsInitted & (cFlagsNeeded)) != (cFlagsNeeded))
-                        {
-                            printf("IMG_Init() failed, error = %s\n", IMG_GetError());
-                            fResult = false;
-                        }
-                    }
                 }
             }
         }
         return fResult;
     }
 
+    // This bit will allow us to load PNG files, which I am storing all my images assets as.  Left
+    // until we know there's no asset pack, it's a good part of startup
+    bool InitializeSDLImage()
+    {
+        bool fResult = true;
+        const int cFlagsNeeded = IMG_INIT_PNG | IMG_INIT_JPG;
+        int iFlagsInitted = IMG_Init(cFlagsNeeded);
+        if ((iFlagsInitted & (cFlagsNeeded)) != (cFlagsNeeded))
+        {
+            printf("IMG_Init() failed, error = %s\n", IMG_GetError());
+            fResult = false;
+        }
+        return fResult;
+    }
+
+    // Headless runs (soak tests, bulk simulation) need the timer and the event queue (so
+    // Ctrl+C still posts SDL_QUIT) but no video subsystem, window, renderer or SDL_image
+    bool InitializeSDLHeadless()
+    {
+        bool fResult = true;
+        if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_EVENTS) < 0)
+        {
+            printf("SDL_Init() failed, error = %s\n", SDL_GetError());
+            fResult = false;
+        }
+        return fResult;
+    }
+
+#ifndef NDEBUG
+    Uint32 HeapAllocationCount()
+    {
+        return static_cast<Uint32>(SDL_AtomicGet(&s_cHeapAllocations));
+    }
+#endif
+
     // Modified from StackOverflow answer
     double Distance(Uint16 row1, Uint16 col1, Uint16 row2, Uint16 col2)
     {
@@ -157,6 +255,37 @@ namespace PacManClone
         }
     }
 
+    TextureWrapper::TextureWrapper(SDL_Texture *pTexture, const char *szName, size_t cchName) : TextureWrapper()
+    {
+        size_t bytesToAllocate = cchName + 1;
+        _pszFilename = new char[bytesToAllocate];
+        SDL_memset(_pszFilename, 0, bytesToAllocate);
+        SDL_memcpy(_pszFilename, szName, cchName);
+
+        SetTexture(pTexture, _pszFilename);
+    }
+
+    void TextureWrapper::SetTexture(SDL_Texture *pTexture, const char *szName)
+    {
+        if (szName != _pszFilename)
+        {
+            size_t bytesToAllocate = SDL_strlen(szName) + 1;
+            delete[] _pszFilename;
+            _pszFilename = new char[bytesToAllocate];
+            SDL_memcpy(_pszFilename, szName, bytesToAllocate);
+        }
+
+        if (_pTexture != nullptr)
+        {
+            SDL_DestroyTexture(_pTexture);
+        }
+        _pTexture = pTexture;
+        if (SDL_QueryTexture(_pTexture, nullptr, nullptr, &_cxTexture, &_cyTexture) != 0)
+        {
+            printf("SDL_QueryTexture() failed, error = %s\n", SDL_GetError());
+        }
+    }
+
     TextureWrapper::~TextureWrapper()
     {
         if (_pTexture != nullptr)
@@ -167,5 +296,85 @@ namespace PacManClone
         }
         delete[] _pszFilename;
     }
+
+    MappedFile::MappedFile() :
+        _pData(nullptr),
+        _cbData(0),
+#ifdef _WIN32
+        _hFile(INVALID_HANDLE_VALUE),
+        _hMapping(nullptr)
+#else
+        _fd(-1)
+#endif
+    {
+    }
+
+    bool MappedFile::Open(const char *pszPath)
+    {
+        SDL_assert(!IsOpen());
+#ifdef _WIN32
+        _hFile = CreateFileA(pszPath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER cbFile = { };
+        if ((_hFile != INVALID_HANDLE_VALUE) && GetFileSizeEx(_hFile, &cbFile) && (cbFile.QuadPart != 0))
+        {
+            _hMapping = CreateFileMappingA(_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (_hMapping != nullptr)
+            {
+                _pData = static_cast<const Uint8 *>(MapViewOfFile(_hMapping, FILE_MAP_READ, 0, 0, 0));
+                _cbData = static_cast<size_t>(cbFile.QuadPart);
+            }
+        }
+#else
+        _fd = open(pszPath, O_RDONLY);
+        struct stat fileStat;
+        if ((_fd >= 0) && (fstat(_fd, &fileStat) == 0) && (fileStat.st_size != 0))
+        {
+            void *pMapped = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, _fd, 0);
+            if (pMapped != MAP_FAILED)
+            {
+                _pData = static_cast<const Uint8 *>(pMapped);
+                _cbData = static_cast<size_t>(fileStat.st_size);
+            }
+        }
+#endif
+        if (_pData == nullptr)
+        {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+#ifdef _WIN32
+        if (_pData != nullptr)
+        {
+            UnmapViewOfFile(_pData);
+        }
+        if (_hMapping != nullptr)
+        {
+            CloseHandle(_hMapping);
+            _hMapping = nullptr;
+        }
+        if (_hFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(_hFile);
+            _hFile = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (_pData != nullptr)
+        {
+            munmap(const_cast<Uint8 *>(_pData), _cbData);
+        }
+        if (_fd >= 0)
+        {
+            close(_fd);
+            _fd = -1;
+        }
+#endif
+        _pData = nullptr;
+        _cbData = 0;
+    }
 }
 }
\ No newline at end of file